@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "Bench.h"
+#include "ChessBoard.h"
+#include "Search.h"
+#include "Stats.h"
+
+using namespace std;
+
+//positions from openings, middlegames and endgames, with checks, pins, castling and promotions
+static const char* const benchPositions[] = {
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+	"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+	"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+	"2r3k1/1q1nbppp/r3p3/3pP3/pPpP4/P1Q2N2/2RN1PPP/2R4K b - - 0 1",
+	"8/8/1p1k4/p2p4/P2P1K2/1P6/8/8 w - - 0 1",
+};
+
+uint64_t bench(int depth, int threads, size_t hashMegabytes) {
+	TranspositionTable table(hashMegabytes);
+	SearchLimits limits = {depth, 0, 0};
+	uint64_t totalNodes = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (const char* FENstring : benchPositions) {
+		//load the position without printing the load message
+		ChessBoard board;
+		streambuf* output = cout.rdbuf(NULL);
+		board.loadState(FENstring);
+		cout.rdbuf(output);
+		//each search starts from an empty table, so on one thread its nodes are the same
+		//every run
+		table.clear();
+		Search search(board, table);
+		SearchResult result = search.run(limits, NULL, threads);
+		cout << "Position: " << FENstring << "\nBest move: " << result.bestMove
+			 << "\nNodes: " << result.nodes << '\n';
+		totalNodes += result.nodes;
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout << "\n===========================\nDepth: " << depth << "\nThreads: " << threads
+		 << "\nTotal time (ms): " << uint64_t(seconds * 1000) << "\nNodes searched: "
+		 << totalNodes << "\nNodes/second: " << uint64_t(totalNodes / seconds) << endl;
+	//threads race each other through the shared table, so only one thread's nodes repeat
+	if (threads == 1) {
+		cout << "Signature: " << totalNodes << endl;
+	} else {
+		cout << "Signature: none (the nodes of " << threads << " threads vary between runs, "
+			 << "so only nodes per second compares)" << endl;
+	}
+#ifdef USE_STATS
+	cout << '\n';
+	Stats::dump(cout, false);
+#endif
+	return totalNodes;
+}
+
+void searchScaling(int threads, int depth, size_t hashMegabytes) {
+	//load every position once, without printing the load message
+	Position positions[sizeof(benchPositions) / sizeof(benchPositions[0])];
+	int count = 0;
+	streambuf* output = cout.rdbuf(NULL);
+	for (const char* FENstring : benchPositions) {
+		ChessBoard board;
+		board.loadState(FENstring);
+		positions[count++] = board;
+	}
+	cout.rdbuf(output);
+
+	TranspositionTable table(hashMegabytes);
+	SearchLimits limits = {depth, 0, 0};
+	double baseSeconds = 0;
+	cout << "Depth: " << depth << "\nHash (MB): " << hashMegabytes << "\n\n"
+		 << setw(8) << "Threads" << setw(12) << "Time (ms)" << setw(14) << "Nodes"
+		 << setw(14) << "Nodes/second" << setw(10) << "Speedup" << '\n';
+	//double the threads each row, ending on the most threads
+	for (int used = 1; ; used = min(used * 2, threads)) {
+		uint64_t nodes = 0;
+		double seconds = 0;
+		for (int index = 0; index < count; index++) {
+			//each search starts from an empty table, so it is timed from scratch
+			table.clear();
+			Search search(positions[index], table);
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			SearchResult result = search.run(limits, NULL, used);
+			seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			nodes += result.nodes;
+		}
+		if (used == 1) {
+			baseSeconds = seconds;
+		}
+		cout << setw(8) << used << setw(12) << uint64_t(seconds * 1000) << setw(14) << nodes
+			 << setw(14) << uint64_t(nodes / seconds) << setw(9) << fixed << setprecision(2)
+			 << baseSeconds / seconds << "x" << endl;
+		if (used == threads) {
+			break;
+		}
+	}
+}
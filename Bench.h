@@ -0,0 +1,33 @@
+/* Bench.h - header file for the bench command */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/* Searches each of a fixed set of positions to a fixed depth, from an empty
+ * transposition table, and prints the best move and nodes of each with the total nodes,
+ * time taken and nodes per second. On one thread the total nodes are the same every run
+ * and only change when the search or move handling does, so they are a signature. With
+ * more threads they vary between runs, and only the nodes per second compare
+ *
+ * @param depth: depth to search each position to (at least 1)
+ * @param threads: number of threads to search with
+ * @param hashMegabytes: size of the transposition table
+ * @returns: the total number of nodes
+ */
+uint64_t bench(int depth, int threads, size_t hashMegabytes);
+
+/* Searches each of the bench positions to a fixed depth with 1, 2, 4, ... threads up to
+ * a number of threads, clearing the transposition table before each search, and prints
+ * the time taken to reach the depth, nodes, nodes per second and speedup over one thread
+ * for each number of threads
+ *
+ * @param threads: most threads to search with (the physical cores, for a fair speedup)
+ * @param depth: depth to search each position to
+ * @param hashMegabytes: size of the transposition table
+ */
+void searchScaling(int threads, int depth, size_t hashMegabytes);
+
+#endif
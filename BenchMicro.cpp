@@ -0,0 +1,265 @@
+/* BenchMicro.cpp - times the ChessBoard and Position hot paths one at a time over a
+ * fixed set of positions, printing ns/op, ops/sec and allocations per op
+ *
+ * ./bench_micro            prints the results as JSON
+ * ./bench_micro --csv      prints the results as CSV
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include "ChessBoard.h"
+#include "MoveList.h"
+#include "PackedPosition.h"
+#include "StateInfo.h"
+
+using namespace std;
+
+/******************* Allocation counting *******************/
+
+static uint64_t allocations = 0; //calls to operator new since the program started
+
+void* operator new(size_t size) {
+	allocations++;
+	if (void* memory = malloc(size ? size : 1)) {
+		return memory;
+	}
+	throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	free(memory);
+}
+
+/******************* Benchmarks *******************/
+
+//positions from openings, middlegames and endgames, with checks, pins, castling and promotions
+static const char* const corpus[] = {
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+	"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+	"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+	"4k3/8/8/8/8/8/4q3/4K3 w - - 0 1",
+	"2r3k1/1q1nbppp/r3p3/3pP3/pPpP4/P1Q2N2/2RN1PPP/2R4K b - - 0 1",
+};
+static const int corpusSize = sizeof(corpus) / sizeof(corpus[0]);
+
+/* The timing of one benchmark
+ */
+struct BenchResult {
+	const char* name; //what was timed
+	uint64_t ops; //number of operations timed
+	double seconds; //time taken by the operations
+	uint64_t allocations; //calls to operator new made by the operations
+};
+
+static volatile uint64_t sink; //results of the operations, so they are not optimised away
+
+/* Runs passes of a benchmark until they have taken long enough to time reliably
+ *
+ * @param name: what is being timed
+ * @param pass: runs the operation over the corpus once, returning the operations done
+ * @returns: the timing of the passes
+ */
+template <typename Pass>
+static BenchResult runBench(const char* name, Pass pass) {
+	//warm up the caches and any buffers the operation reuses
+	pass();
+	BenchResult result = {name, 0, 0, 0};
+	uint64_t allocationsBefore = allocations;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	while (result.seconds < 0.2) {
+		result.ops += pass();
+		result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	}
+	result.allocations = allocations - allocationsBefore;
+	return result;
+}
+
+/* Prints the timings as JSON or CSV
+ *
+ * @param output: the output stream to write to
+ * @param results: the timings
+ * @param count: number of timings
+ * @param csv: whether to print CSV instead of JSON
+ */
+static void printResults(ostream& output, const BenchResult results[], int count, bool csv) {
+	if (csv) {
+		output << "name,ops,ns_per_op,ops_per_sec,allocs_per_op\n";
+	} else {
+		output << "[\n";
+	}
+	for (int index = 0; index < count; index++) {
+		const BenchResult& result = results[index];
+		double nsPerOp = result.seconds * 1e9 / result.ops;
+		double opsPerSec = result.ops / result.seconds;
+		double allocsPerOp = double(result.allocations) / result.ops;
+		if (csv) {
+			output << result.name << ',' << result.ops << ',' << nsPerOp << ','
+				   << uint64_t(opsPerSec) << ',' << allocsPerOp << '\n';
+		} else {
+			output << "  {\"name\": \"" << result.name << "\", \"ops\": " << result.ops
+				   << ", \"ns_per_op\": " << nsPerOp << ", \"ops_per_sec\": "
+				   << uint64_t(opsPerSec) << ", \"allocs_per_op\": " << allocsPerOp << '}'
+				   << (index + 1 < count ? ",\n" : "\n");
+		}
+	}
+	if (!csv) {
+		output << "]\n";
+	}
+	output.flush();
+}
+
+int main(int argc, char* argv[]) {
+	bool csv = argc > 1 && strcmp(argv[1], "--csv") == 0;
+	//print the results to standard output, discarding what the ChessBoard prints
+	ostream output(cout.rdbuf());
+	cout.rdbuf(NULL);
+
+	//load each position and its legal moves once for the benchmarks that do not change it
+	static ChessBoard boards[corpusSize];
+	Position positions[corpusSize];
+	MoveList legalMoves[corpusSize];
+	PackedPosition packedCorpus[corpusSize];
+	for (int index = 0; index < corpusSize; index++) {
+		boards[index].loadState(corpus[index]);
+		boards[index].toPacked(packedCorpus[index]);
+		positions[index] = boards[index];
+		positions[index].generateLegalMoves(legalMoves[index]);
+	}
+	ChessBoard board;
+	MoveList moves;
+	StateInfo state;
+
+	BenchResult results[] = {
+		//parsing and checking a FEN string and placing the pieces
+		runBench("loadState", [&]() {
+			for (int index = 0; index < corpusSize; index++) {
+				board.loadState(corpus[index]);
+			}
+			return uint64_t(corpusSize);
+		}),
+		//writing a position as a FEN string
+		runBench("toFEN", [&]() {
+			char FENstring[ChessBoard::MAX_FEN_LENGTH];
+			for (int index = 0; index < corpusSize; index++) {
+				sink = sink + boards[index].toFEN(FENstring);
+			}
+			return uint64_t(corpusSize);
+		}),
+		//packing a position into a 32 byte record
+		runBench("toPacked", [&]() {
+			PackedPosition packed;
+			for (int index = 0; index < corpusSize; index++) {
+				sink = sink + boards[index].toPacked(packed) + packed.pieces[0];
+			}
+			return uint64_t(corpusSize);
+		}),
+		//checking and loading a packed record
+		runBench("loadPacked", [&]() {
+			for (int index = 0; index < corpusSize; index++) {
+				sink = sink + board.loadPacked(packedCorpus[index]);
+			}
+			return uint64_t(corpusSize);
+		}),
+		//validating, making and printing a move, then taking it back
+		runBench("submitMove", [&]() {
+			for (int index = 0; index < corpusSize; index++) {
+				char src[3], dest[3];
+				posOf(legalMoves[index][0].from()).toString(src);
+				posOf(legalMoves[index][0].to()).toString(dest);
+				boards[index].submitMove(src, dest);
+				boards[index].unmakeMove();
+			}
+			return uint64_t(corpusSize);
+		}),
+		//the same without any printing, returning a MoveResult
+		runBench("submitMove_silent", [&]() {
+			for (int index = 0; index < corpusSize; index++) {
+				char src[3], dest[3];
+				posOf(legalMoves[index][0].from()).toString(src);
+				posOf(legalMoves[index][0].to()).toString(dest);
+				sink = sink + boards[index].submitMove(src, dest, NULL).status;
+				boards[index].unmakeMove();
+			}
+			return uint64_t(corpusSize);
+		}),
+		//rejecting a move that is not legal, which is looked up in the cached legal moves
+		//since the position has not changed (hasLegalMove caches them on the first pass,
+		//as checkGameState does after each move made)
+		runBench("submitMove_rejected", [&]() {
+			for (int index = 0; index < corpusSize; index++) {
+				char src[3];
+				sink = sink + boards[index].hasLegalMove();
+				posOf(legalMoves[index][0].from()).toString(src);
+				sink = sink + boards[index].submitMove(src, src, NULL).status;
+			}
+			return uint64_t(corpusSize);
+		}),
+		//all legal moves of a position, which checkGameState uses to find checkmate
+		runBench("generateLegalMoves", [&]() {
+			for (int index = 0; index < corpusSize; index++) {
+				positions[index].generateLegalMoves(moves);
+				sink = sink + moves.size();
+			}
+			return uint64_t(corpusSize);
+		}),
+		//the pin and check mask test that tryValidMove ends with
+		runBench("isLegal", [&]() {
+			uint64_t ops = 0;
+			for (int index = 0; index < corpusSize; index++) {
+				for (Move move : legalMoves[index]) {
+					sink = sink + positions[index].isLegal(move);
+					ops++;
+				}
+			}
+			return ops;
+		}),
+		//the movement rules tryValidMove checks a destination against
+		runBench("pieceMoves", [&]() {
+			uint64_t ops = 0;
+			for (int index = 0; index < corpusSize; index++) {
+				for (Bitboard own = positions[index].occupied(); own; ops++) {
+					sink = sink + positions[index].pieceMoves(popLsb(own));
+				}
+			}
+			return ops;
+		}),
+		//making and undoing a move on a Position, which also finds checks and pins
+		runBench("doMove+undoMove", [&]() {
+			uint64_t ops = 0;
+			for (int index = 0; index < corpusSize; index++) {
+				for (Move move : legalMoves[index]) {
+					positions[index].doMove(move, state);
+					sink = sink + positions[index].getCheckers();
+					positions[index].undoMove(state);
+					ops++;
+				}
+			}
+			return ops;
+		}),
+		//making and unmaking a move on a ChessBoard, moving its piece codes too
+		runBench("makeMove+unmakeMove", [&]() {
+			uint64_t ops = 0;
+			for (int index = 0; index < corpusSize; index++) {
+				for (Move move : legalMoves[index]) {
+					boards[index].makeMove(move);
+					boards[index].unmakeMove();
+					ops++;
+				}
+			}
+			return ops;
+		}),
+	};
+	printResults(output, results, sizeof(results) / sizeof(results[0]), csv);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/* Bitboard.h - header file for the Bitboard type and its helper functions */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include "Pos.h"
+
+/******************* Bitboard type *******************/
+
+//64-bit set of squares, bit (row * 8 + col) is set for each square in the set
+typedef uint64_t Bitboard;
+
+const Bitboard FILE_A_BB = 0x0101010101010101ULL; //all squares in column 0
+const Bitboard FILE_H_BB = FILE_A_BB << 7; //all squares in column 7
+const Bitboard ROW_0_BB = 0xFFULL; //all squares in row 0 (rank 8)
+const Bitboard ROW_7_BB = ROW_0_BB << 56; //all squares in row 7 (rank 1)
+
+/***************** Bitboard functions *****************/
+
+/* Converts a Pos into a square index
+ *
+ * @param pos: position in row and column form
+ * @returns: square index from 0 (A8) to 63 (H1)
+ */
+constexpr int squareOf(Pos pos) {
+	return pos.index();
+}
+
+/* Converts a square index into a Pos
+ *
+ * @param square: square index from 0 (A8) to 63 (H1)
+ * @returns: position in row and column form
+ */
+constexpr Pos posOf(int square) {
+	return Pos::fromSquare(square);
+}
+
+/* Gets the Bitboard containing a single square
+ *
+ * @param square: square index
+ * @returns: Bitboard with only that square set
+ */
+constexpr Bitboard squareBB(int square) {
+	return 1ULL << square;
+}
+
+/* Gets the Bitboard of the row containing a square
+ *
+ * @param square: square index
+ * @returns: Bitboard of every square in the row
+ */
+constexpr Bitboard rowBB(int square) {
+	return ROW_0_BB << (square & 56);
+}
+
+/* Gets the Bitboard of the column containing a square
+ *
+ * @param square: square index
+ * @returns: Bitboard of every square in the column
+ */
+constexpr Bitboard colBB(int square) {
+	return FILE_A_BB << (square & 7);
+}
+
+/* Gets the lowest square in a non-empty Bitboard
+ *
+ * @param b: non-empty Bitboard
+ * @returns: index of the lowest set square
+ */
+inline int lsb(Bitboard b) {
+	return __builtin_ctzll(b);
+}
+
+/* Gets the highest square in a non-empty Bitboard
+ *
+ * @param b: non-empty Bitboard
+ * @returns: index of the highest set square
+ */
+inline int msb(Bitboard b) {
+	return 63 - __builtin_clzll(b);
+}
+
+/* Removes the lowest square from a non-empty Bitboard
+ *
+ * @param b: non-empty Bitboard to pop from
+ * @returns: index of the removed square
+ */
+inline int popLsb(Bitboard& b) {
+	int square = lsb(b);
+	b &= b - 1;
+	return square;
+}
+
+/* Counts the squares in a Bitboard
+ *
+ * @param b: Bitboard to count
+ * @returns: number of set squares
+ */
+inline int popCount(Bitboard b) {
+	return __builtin_popcountll(b);
+}
+
+#endif
@@ -1,491 +1,628 @@
 #include <iostream>
 #include "ChessBoard.h"
 #include "ChessPiece.h"
+#include "MoveList.h"
+#include "MoveObserver.h"
+#include "PackedPosition.h"
+#include "Moves.h"
+#include "StateInfo.h"
+#include "Stats.h"
 
 using namespace std;
 
 ChessBoard::ChessBoard() {
-	for (int row = 0; row < 8; row++) {
-		for (int col = 0; col < 8; col++) {
-			//set all squares on the board to NULL
-			board[row][col] = NULL;
-		}
+	//set all squares on the board to empty
+	for (int square = 0; square < 64; square++) {
+		board[square] = 0;
 	}
-	//default white player to move
-	sideToMove = ChessBoard::WHITE;
+	startPly = 0;
+	legalMoveCount = -1;
 };
 
-void ChessBoard::loadState(const char* FENstring) {
+//what loadState prints for each FEN_STATUS other than LOADED
+static const char* const FENerrors[] = {"", "piece placement", "number of kings", "active colour",
+	"castling availability", "en passant square", "halfmove clock", "fullmove number"};
+
+ChessBoard::FEN_STATUS ChessBoard::loadState(const char* FENstring) {
+	STATS_TIME(LOAD_STATE);
 	//clear board of any previous pieces
 	destruct();
 
-	int row = 0, col = 0;
-	//load board with ChessPieces
-	FENstring = loadBoard(row, col, FENstring);
-	//get active colour
-	FENstring = getSideToMove(FENstring);
-	//get castling availability (should correspond to the state of the board loaded)
-	castlingState = FENstring;
+	//read each field, stopping at the first that is invalid
+	FEN_STATUS status = LOADED;
+	int halfmoves = 0, fullmoves = 1;
+	if (!(FENstring = loadBoard(FENstring))) {
+		status = INVALID_BOARD;
+	} else if (popCount(pieces(WHITE, KING)) != 1 || popCount(pieces(BLACK, KING)) != 1) {
+		status = INVALID_KINGS;
+	} else if (!(FENstring = loadSideToMove(FENstring))) {
+		status = INVALID_SIDE_TO_MOVE;
+	} else if (!(FENstring = loadCastlingRights(FENstring))) {
+		status = INVALID_CASTLING;
+	} else if (!(FENstring = loadEnPassant(FENstring))) {
+		status = INVALID_EN_PASSANT;
+	} else if (!(FENstring = loadNumber(FENstring, 0, 65535, halfmoves))) {
+		status = INVALID_HALFMOVE_CLOCK;
+	} else if (!(FENstring = loadNumber(FENstring, 1, 1000000, fullmoves)) || *FENstring) {
+		status = INVALID_FULLMOVE_NUMBER;
+	}
+	if (status != LOADED) {
+		destruct();
+		cout << "Cannot load the board state: invalid " << FENerrors[status]
+			 << " in the FEN string!" << endl;
+		return status;
+	}
+	finishLoad(halfmoves, fullmoves);
 
 	cout << "A new board state is loaded!" << endl;
+	return LOADED;
+}
+
+void ChessBoard::finishLoad(int halfmoves, int fullmoves) {
+	halfmoveClock = uint16_t(halfmoves);
+	startPly = 2 * (fullmoves - 1) + (sideToMove == BLACK);
+	key = computeKey();
+	updateCheckInfo();
+}
+
+bool ChessBoard::loadPackedBoard(const PackedPosition& packed) {
+	Bitboard occupancy = packed.getOccupancy();
+	if (popCount(occupancy) > PackedPosition::MAX_PIECES) {
+		return false;
+	}
+	//the pieces are in square order, two to a byte with the first in the low nibble
+	for (int index = 0; occupancy; index++) {
+		uint8_t code = (packed.pieces[index / 2] >> (4 * (index & 1))) & 15;
+		if (!placePiece(popLsb(occupancy), code)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+ChessBoard::FEN_STATUS ChessBoard::loadPacked(const PackedPosition& packed) {
+	//clear board of any previous pieces
+	destruct();
+
+	//check each field in the order of a FEN string, stopping at the first that is invalid
+	FEN_STATUS status = LOADED;
+	int fullmoves = int(packed.getFullmoveNumber());
+	sideToMove = (packed.flags & PackedPosition::WHITE_TO_MOVE) ? WHITE : BLACK;
+	if (!loadPackedBoard(packed)) {
+		status = INVALID_BOARD;
+	} else if (popCount(pieces(WHITE, KING)) != 1 || popCount(pieces(BLACK, KING)) != 1) {
+		status = INVALID_KINGS;
+	} else if (packed.flags & ~(PackedPosition::CASTLING_MASK | PackedPosition::WHITE_TO_MOVE)) {
+		status = INVALID_CASTLING;
+	} else if (!setEnPassant((packed.epSquare == PackedPosition::NO_SQUARE) ? -1
+																			: packed.epSquare)) {
+		status = INVALID_EN_PASSANT;
+	} else if (fullmoves < 1 || fullmoves > 1000000) {
+		status = INVALID_FULLMOVE_NUMBER;
+	}
+	if (status != LOADED) {
+		destruct();
+		return status;
+	}
+	setCastlingRights(packed.flags & PackedPosition::CASTLING_MASK);
+	finishLoad(packed.getHalfmoveClock(), fullmoves);
+	return LOADED;
+}
+
+bool ChessBoard::toPacked(PackedPosition& packed) const {
+	Bitboard occupancy = occupied();
+	if (popCount(occupancy) > PackedPosition::MAX_PIECES) {
+		return false;
+	}
+	packed = PackedPosition();
+	packed.setOccupancy(occupancy);
+	//the pieces are in square order, two to a byte with the first in the low nibble
+	for (int index = 0; occupancy; index++) {
+		int square = popLsb(occupancy);
+		packed.pieces[index / 2] |= board[square] << (4 * (index & 1));
+	}
+	packed.flags = castlingRights | ((sideToMove == WHITE) ? PackedPosition::WHITE_TO_MOVE : 0);
+	packed.epSquare = (epSquare == -1) ? PackedPosition::NO_SQUARE : uint8_t(epSquare);
+	packed.setHalfmoveClock(halfmoveClock);
+	packed.setFullmoveNumber(uint32_t(startPly + history.size()) / 2 + 1);
+	return true;
+}
+
+uint8_t ChessBoard::pieceCode(COLOUR colour, PIECE type) {
+	return uint8_t(colour * 8 + type + 1);
 }
 
-ChessPiece* ChessBoard::makePiece (Pos pos, char FENchar) {
+uint8_t ChessBoard::pieceCode(char FENchar) {
 	//store colour and convert FENchar to lowercase
-	COLOUR colour; 
-	if ('a' <= FENchar && FENchar <= 'z') {
-		colour = ChessBoard::BLACK;
-	} else {
+	COLOUR colour = ChessBoard::BLACK;
+	if ('A' <= FENchar && FENchar <= 'Z') {
 		colour = ChessBoard::WHITE;
 		FENchar += 32;
 	}
-	//make pieces based on FENchar
-	switch (FENchar) {
-		case 'r':
-			return new Rook(pos, colour);
-		case 'n':
-			return new Knight(pos, colour);
-		case 'b':
-			return new Bishop(pos, colour);
-		case 'q':
-			return new Queen(pos, colour);
-		case 'k':
-			//update position of kings
-			kingPos[colour] = pos;
-			return new King(pos, colour);
-		case 'p':
-			return new Pawn(pos, colour);
+	//find the type from its position in the FEN chars of the types
+	for (int type = PAWN; type <= KING; type++) {
+		if ("pnbrqk"[type] == FENchar) {
+			return pieceCode(colour, static_cast<PIECE>(type));
+		}
 	}
-	return NULL;
+	return 0;
 }
 
-const char* ChessBoard::loadBoard(int& row, int& col, const char* FENstring) {
+bool ChessBoard::placePiece(int square, uint8_t code) {
+	//the code must be a type from PAWN to KING, with the colour in bit 3
+	int type = (code & 7) - 1;
+	if (code > 15 || type < PAWN || type > KING) {
+		return false;
+	}
+	//pawns can never stand on the first or last row
+	if (type == PAWN && (square < 8 || square >= 56)) {
+		return false;
+	}
+	//add the piece to the board and the Bitboards
+	setSquare(square, code);
+	togglePiece(static_cast<COLOUR>(code >> 3), static_cast<PIECE>(type), square);
+	return true;
+}
+
+const char* ChessBoard::loadBoard(const char* FENstring) {
+	int row = 0, col = 0;
 	//continue until first field of FENstring is read
-	while (*FENstring != ' ') {
-		//if char is '/' move to next row
+	for (; *FENstring != ' ' && *FENstring != '\0'; FENstring++) {
+		//if char is '/' move to next row, once the row is full
 		if (*FENstring == '/') {
+			if (col != 8 || ++row == 8) {
+				return NULL;
+			}
 			col = 0;
-			row++;
-			FENstring++;
 			continue;
 		}
 		//if char is a number then skip that number of squares
 		if ('1' <= *FENstring && *FENstring <= '8') {
-			col += *FENstring - '1' + 1;
+			col += *FENstring - '0';
 		} 
-		// else create the piece
+		// else place the piece
 		else {
-			board[row][col] = makePiece(Pos(row,col), *FENstring);
+			if (col == 8 || !placePiece(row * 8 + col, pieceCode(*FENstring))) {
+				return NULL;
+			}
 			col++;
 		}
+		if (col > 8) {
+			return NULL;
+		}
+	}
+	//the last row must be full too
+	if (row != 7 || col != 8) {
+		return NULL;
+	}
+	return FENstring;
+}
+
+/* Moves a FENstring pointer past the spaces before the next field
+ *
+ * @param FENstring: pointer into a FEN string
+ * @returns: the FENstring pointer at the next field, or at the '\0'
+ */
+static const char* skipSpaces(const char* FENstring) {
+	while (*FENstring == ' ') {
 		FENstring++;
 	}
+	return FENstring;
+}
+
+const char* ChessBoard::loadSideToMove(const char* FENstring) {
+	FENstring = skipSpaces(FENstring);
+	//set sideToMove with active colour
+	if (*FENstring == 'w') {
+		sideToMove = ChessBoard::WHITE;
+	} else if (*FENstring == 'b') {
+		sideToMove = ChessBoard::BLACK;
+	} else {
+		return NULL;
+	}
 	FENstring++;
+	return (*FENstring == ' ' || *FENstring == '\0') ? FENstring : NULL;
+}
+
+const char* ChessBoard::loadCastlingRights(const char* FENstring) {
+	FENstring = skipSpaces(FENstring);
+	castlingRights = 0;
+	//a missing field or '-' means neither player can castle
+	if (*FENstring == '\0') {
+		return FENstring;
+	}
+	if (*FENstring == '-') {
+		FENstring++;
+	}
+	for (; *FENstring != '\0' && *FENstring != ' '; FENstring++) {
+		int right = 0;
+		switch (*FENstring) {
+			case 'K':
+				right = WHITE_KINGSIDE;
+				break;
+			case 'Q':
+				right = WHITE_QUEENSIDE;
+				break;
+			case 'k':
+				right = BLACK_KINGSIDE;
+				break;
+			case 'q':
+				right = BLACK_QUEENSIDE;
+				break;
+		}
+		//each right can only be given once, and not after '-'
+		if (!right || (castlingRights & right) || FENstring[-1] == '-') {
+			return NULL;
+		}
+		castlingRights |= right;
+	}
+	setCastlingRights(castlingRights);
 	return FENstring;
 }
 
-const char* ChessBoard::getSideToMove(const char* FENstring) {
-	//continune until the second field of FENstring is read
-	while (*FENstring != ' ') {
-		//set sideToMove with active colour
-		if (*FENstring == 'w') {
-			sideToMove = ChessBoard::WHITE;
-		} else if (*FENstring == 'b') {
-			sideToMove = ChessBoard::BLACK;
+void ChessBoard::setCastlingRights(int rights) {
+	castlingRights = uint8_t(rights);
+	//keep only the rights whose king and rook are still on their start squares
+	if (!(pieces(WHITE, KING) & squareBB(60))) {
+		castlingRights &= ~(WHITE_KINGSIDE | WHITE_QUEENSIDE);
+	}
+	if (!(pieces(BLACK, KING) & squareBB(4))) {
+		castlingRights &= ~(BLACK_KINGSIDE | BLACK_QUEENSIDE);
+	}
+	const int rookSquares[4] = {63, 56, 7, 0};
+	const COLOUR rookColours[4] = {WHITE, WHITE, BLACK, BLACK};
+	for (int index = 0; index < 4; index++) {
+		if (!(pieces(rookColours[index], ROOK) & squareBB(rookSquares[index]))) {
+			castlingRights &= ~(1 << index);
 		}
+	}
+}
+
+const char* ChessBoard::loadEnPassant(const char* FENstring) {
+	FENstring = skipSpaces(FENstring);
+	epSquare = -1;
+	//a missing field or '-' means no pawn can be taken en passant
+	if (*FENstring == '\0') {
+		return FENstring;
+	}
+	if (*FENstring == '-') {
 		FENstring++;
+		return (*FENstring == ' ' || *FENstring == '\0') ? FENstring : NULL;
 	}
-	FENstring++;
-	return FENstring;
+	char file = FENstring[0], rank = FENstring[1];
+	if (file < 'a' || file > 'h' || rank < '1' || rank > '8'
+			|| (FENstring[2] != ' ' && FENstring[2] != '\0')) {
+		return NULL;
+	}
+	if (!setEnPassant((7 - (rank - '1')) * 8 + (file - 'a'))) {
+		return NULL;
+	}
+	return FENstring + 2;
+}
+
+bool ChessBoard::setEnPassant(int square) {
+	epSquare = -1;
+	if (square == -1) {
+		return true;
+	}
+	//the square must be behind a pawn that has just moved two squares
+	if (square < 0 || square >= 64 || (square >> 3) != ((sideToMove == WHITE) ? 2 : 5)) {
+		return false;
+	}
+	int pawnSquare = (sideToMove == WHITE) ? square + 8 : square - 8;
+	int startSquare = (sideToMove == WHITE) ? square - 8 : square + 8;
+	COLOUR opponent = static_cast<COLOUR>(sideToMove ^ WHITE ^ BLACK);
+	if (!(pieces(opponent, PAWN) & squareBB(pawnSquare))
+			|| (occupied() & (squareBB(square) | squareBB(startSquare)))) {
+		return false;
+	}
+	//like doMove, only keep the square if a pawn can take on it
+	if (pawnAttacks(opponent, square) & pieces(sideToMove, PAWN)) {
+		epSquare = int8_t(square);
+	}
+	return true;
+}
+
+const char* ChessBoard::loadNumber(const char* FENstring, int min, int max, int& value) {
+	FENstring = skipSpaces(FENstring);
+	//a missing field keeps the default value
+	if (*FENstring == '\0') {
+		return FENstring;
+	}
+	int number = 0;
+	const char* start = FENstring;
+	for (; '0' <= *FENstring && *FENstring <= '9'; FENstring++) {
+		number = number * 10 + (*FENstring - '0');
+		if (number > max) {
+			return NULL;
+		}
+	}
+	if (FENstring == start || number < min || (*FENstring != ' ' && *FENstring != '\0')) {
+		return NULL;
+	}
+	value = number;
+	return skipSpaces(FENstring);
+}
+
+/* Writes a whole number in decimal
+ *
+ * @param number: the number to write
+ * @param text: set to the digits, which are not followed by a '\0'
+ * @returns: the text pointer after the digits
+ */
+static char* writeNumber(unsigned number, char* text) {
+	//write the digits backwards, then copy them in order
+	char digits[10];
+	int count = 0;
+	do {
+		digits[count++] = char('0' + number % 10);
+		number /= 10;
+	} while (number);
+	while (count) {
+		*text++ = digits[--count];
+	}
+	return text;
+}
+
+int ChessBoard::toFEN(char* FENstring) const {
+	//FEN chars of each piece code
+	static const char FENchars[16] = {0, 'p', 'n', 'b', 'r', 'q', 'k', 0,
+									  0, 'P', 'N', 'B', 'R', 'Q', 'K', 0};
+	char* text = FENstring;
+	for (int row = 0; row < 8; row++) {
+		//count each run of empty squares, writing it before the next piece
+		int empty = 0;
+		for (int col = 0; col < 8; col++) {
+			uint8_t code = board[row * 8 + col];
+			if (!code) {
+				empty++;
+				continue;
+			}
+			if (empty) {
+				*text++ = char('0' + empty);
+				empty = 0;
+			}
+			*text++ = FENchars[code];
+		}
+		if (empty) {
+			*text++ = char('0' + empty);
+		}
+		*text++ = (row < 7) ? '/' : ' ';
+	}
+	*text++ = (sideToMove == WHITE) ? 'w' : 'b';
+	*text++ = ' ';
+	//castling rights in the order of "KQkq", which is the order of their flags
+	if (!castlingRights) {
+		*text++ = '-';
+	}
+	for (int index = 0; index < 4; index++) {
+		if (castlingRights & (1 << index)) {
+			*text++ = "KQkq"[index];
+		}
+	}
+	*text++ = ' ';
+	if (epSquare == -1) {
+		*text++ = '-';
+	} else {
+		*text++ = char('a' + (epSquare & 7));
+		*text++ = char('8' - (epSquare >> 3));
+	}
+	*text++ = ' ';
+	text = writeNumber(halfmoveClock, text);
+	*text++ = ' ';
+	text = writeNumber(unsigned(startPly + history.size()) / 2 + 1, text);
+	*text = '\0';
+	return int(text - FENstring);
 }
 
 void ChessBoard::submitMove(const char* src, const char* dest) {
+	//print the result, with the board, in a single write
+	PrintingObserver printer(cout);
+	submitMove(src, dest, &printer);
+}
+
+MoveResult ChessBoard::submitMove(const char* src, const char* dest, MoveObserver* observer) {
+	STATS_TIME(SUBMIT_MOVE);
+	MoveResult result;
+	playMove(src, dest, result);
+	if (observer) {
+		observer->moveSubmitted(*this, src, dest, result);
+	}
+	return result;
+}
+
+void ChessBoard::playMove(const char* src, const char* dest, MoveResult& result) {
+	result.move = Move();
+	result.colour = sideToMove;
+	result.piece = result.captured = -1;
+	result.check = result.checkmate = result.stalemate = false;
 	//get positions of the arguments in row and column form
 	Pos srcPos(src);
 	Pos destPos(dest);
 	//if any position is invalid, return
-	if (srcPos.row == -1 || destPos.row == -1) {
-		cout << "Invalid position inputted" << endl;
+	if (!srcPos.isValid() || !destPos.isValid()) {
+		result.status = MoveResult::INVALID_POSITION;
 		return;
 	}
 	//get source piece
-	ChessPiece* srcPiece = board[srcPos.row][srcPos.col];
+	const ChessPiece* srcPiece = pieceAt(srcPos);
 	//if piece doesn't exist, return
 	if (!srcPiece) {
-		cout << "There is no piece at position " << src << "!" << endl;
+		result.status = MoveResult::NO_PIECE;
 		return;
 	}
+	result.colour = srcPiece->getColour();
+	result.piece = srcPiece->getType();
 	//check if piece is the colour which has the move
 	if (srcPiece->getColour() != sideToMove) {
-		cout << "It is not " << srcPiece->getColour() << "'s turn to move!" << endl;
+		result.status = MoveResult::WRONG_TURN;
 		return;
 	}
 	//check if move is valid
-	if (!tryValidMove(srcPiece, srcPos, destPos)) {
-		cout << srcPiece << " cannot move to " << dest << "!" << endl;
+	Move move;
+	if (!tryValidMove(srcPiece, srcPos, destPos, move)) {
+		result.status = MoveResult::ILLEGAL_MOVE;
 		return;
 	}
-	//update castlingState based on piece and its position
-	updateCastlingState(srcPiece);
 	//make the move
-	makeMove(src, srcPos, dest, destPos);
-	//reset isCastling after the move
-	resetIsCastling(srcPiece);
+	makeMove(move);
+	result.status = MoveResult::MOVED;
+	result.move = move;
+	result.captured = history.back().captured;
 	//check for check or checkmate or stalemate
-	checkGameState();
-	cout << *this << endl;
-}
-
-ChessPiece* ChessBoard::movePiece(Pos src, Pos dest) {
-	//get source and destnation pieces
-	ChessPiece* srcPiece = board[src.row][src.col];
-	ChessPiece* destPiece = board[dest.row][dest.col];
-	//insert source piece at destnation and update piece's position
-	board[dest.row][dest.col] = srcPiece;
-	board[dest.row][dest.col]->setPos(dest);
-	//if the piece to move is a king
-	if (srcPiece->getSymbol() == 'k' || srcPiece->getSymbol() == 'K') {
-		//update position of the king
-		kingPos[srcPiece->getColour()] = dest;
-		//if isCastling, move the corresponding Rook
-		if (((King*)srcPiece)->isCastling) {
-			if (dest.col == 6) {
-				movePiece(Pos(dest.row, dest.col + 1), Pos(dest.row, dest.col - 1));
-				//undo changeSides done by movePiece
-				changeSides();
-			} else if (dest.col == 1) {
-				movePiece(Pos(dest.row, dest.col - 1), Pos(dest.row, dest.col + 1));
-				changeSides();
-			}
-		}
-	}
-	//set source location to NULL
-	board[src.row][src.col] = NULL;
-	//switch which player has the move
-	changeSides();
-	//return NULL or the piece at the destination
-	return destPiece;
-}
-
-void ChessBoard::undoMove(Pos dest_o, Pos src_o, ChessPiece* takenPiece) {
-	//get original destination piece
-	ChessPiece* destPiece_o = board[dest_o.row][dest_o.col];
-	//put original destination piece back into original source position
-	board[src_o.row][src_o.col] = destPiece_o;
-	//update position if not NULL
-	if (board[src_o.row][src_o.col]) {
-		board[src_o.row][src_o.col]->setPos(src_o);
-	}
-	//if the original destination piece was a king
-	if (destPiece_o->getSymbol() == 'k' || destPiece_o->getSymbol() == 'K') {
-		//update position of the king
-		kingPos[destPiece_o->getColour()] = src_o;
-		//if isCastling, revert the corresponding Rook's move
-		if (((King*)destPiece_o)->isCastling) {
-			if (dest_o.col == 6) {
-				undoMove(Pos(dest_o.row, dest_o.col - 1), 
-						Pos(dest_o.row, dest_o.col + 1), NULL);
-				//undo changeSides done by undoMove
-				changeSides();
-			} else if (dest_o.col == 1) {
-				undoMove(Pos(dest_o.row, dest_o.col + 1),
-						Pos(dest_o.row, dest_o.col - 1), NULL);
-				changeSides();
-			}
-		}
-	}
-	//put piece that was taken back into the original destination position
-	board[dest_o.row][dest_o.col] = takenPiece;
-	//update position if not NULL
-	if (board[dest_o.row][dest_o.col]) {
-		board[dest_o.row][dest_o.col]->setPos(dest_o);
-	}
-	//switch which player has the move
-	changeSides();
+	checkGameState(result);
 }
 
-bool ChessBoard::tryValidMove(ChessPiece* piece, Pos src, Pos dest) {
-	//if positions are the same, move is not valid
-	if (src == dest) {
-		return false;
-	}
-	//get piece at destination
-	ChessPiece* destPiece = board[dest.row][dest.col];
-	//if piece is the same colour as the destination piece or player is trying to move
-	//to an empty square but it is not their move, return false
-	if ((destPiece && piece->getColour() == destPiece->getColour())
-			|| (destPiece == NULL && piece->getColour() != sideToMove)) {
-		return false;
-	}
-	//if piece is a king
-	if (piece->getSymbol() == 'k' || piece->getSymbol() == 'K') {
-		//check if it is not a castling move or a valid move
-		if (!((King*)piece)->isCastlingMove(src, dest, (const ChessPiece* (*)[8])board, 
-											castlingState)
-				&& !piece->isValidMove(src, dest, (const ChessPiece* (*)[8])board)) {
-			return false;
-		}
-	//else check if it is a valid move
-	} else if (!piece->isValidMove(src, dest, (const ChessPiece* (*)[8])board)) {
-		return false;
+void ChessBoard::cacheLegalMoves() const {
+	if (legalMoveCount != -1) {
+		return;
 	}
-	//try the move
-	ChessPiece* capturedPiece = movePiece(src, dest);
-	//if move results in check, return false
-	if (isCheck(kingPos[piece->getColour()])) {
-		undoMove(dest, src, capturedPiece);
-		return false;
+	MoveList moves;
+	generateLegalMoves(moves);
+	//set a bit for each move, from its source square to its destination
+	for (int square = 0; square < 64; square++) {
+		legalTargets[square] = 0;
 	}
-	//undo the move
-	else {
-		undoMove(dest, src, capturedPiece);
+	for (Move move : moves) {
+		legalTargets[move.from()] |= squareBB(move.to());
 	}
-	//if all checks pass, return true
-	return true;
+	legalMoveCount = moves.size();
 }
 
-void ChessBoard::changeSides() {
-	//toggle colour enum value using XOR to change turns
-	sideToMove = static_cast<COLOUR>(sideToMove ^ WHITE ^ BLACK);
+bool ChessBoard::hasLegalMove() const {
+	cacheLegalMoves();
+	return legalMoveCount > 0;
 }
 
-void ChessBoard::makeMove(const char* src, Pos srcPos, const char* dest, Pos destPos) {
-	cout << board[srcPos.row][srcPos.col] << " moves from " << src << " to " << dest;
-	//get destination piece if it was taken
-	ChessPiece* takenPiece = movePiece(srcPos, destPos);
-	if (takenPiece) {
-		cout << " taking " << takenPiece;
-		//free the taken piece's pointer
-		delete takenPiece;
-		takenPiece = NULL;
+bool ChessBoard::tryValidMove(const ChessPiece* piece, Pos src, Pos dest, Move& move) const {
+	STATS_COUNT(TRY_VALID_MOVE);
+	int from = squareOf(src), to = squareOf(dest);
+	//only the player who has the move can move
+	if (piece->getColour() != sideToMove) {
+		return false;
 	}
-}
-
-void ChessBoard::checkGameState() {
-	//check if there is a piece that can take the king
-	const ChessPiece* checkingPiece = isCheck(kingPos[sideToMove]);
-	if (checkingPiece) {
-		cout << '\n' << sideToMove  << " is in ";
-		//check for checkmate
-		if (isCheckmate(kingPos[sideToMove], checkingPiece)) {
-			cout << "checkmate";
-		} else {
-			cout << "check";
-		}
+	//a king moving two squares along its row is castling
+	bool castling = piece->getType() == KING && (to - from == 2 || from - to == 2);
+	if (castling) {
+		move = Move(from, to, Move::CASTLING);
+	}
+	//a pawn moving diagonally onto epSquare is taking en passant
+	else if (piece->getType() == PAWN && to == epSquare
+			&& (pawnAttacks(sideToMove, from) & squareBB(to))) {
+		move = Move(from, to, Move::EN_PASSANT);
+	}
+	//a pawn reaching the last row is promoted to a queen
+	else if (piece->getType() == PAWN && (squareBB(to) & (ROW_0_BB | ROW_7_BB))) {
+		move = Move(from, to, Move::PROMOTION, QUEEN);
 	} else {
-		//check for stalemate
-		if (!boardHasValidMove(sideToMove)) {
-			cout << "stalemate";
+		move = Move(from, to);
+	}
+	//if the legal moves of the position are cached, the move is a lookup
+	if (legalMoveCount != -1) {
+		return legalTargets[from] & squareBB(to);
+	}
+	//otherwise castling must be one of the castling moves
+	if (castling) {
+		MoveList castlingMoves;
+		addCastlingMoves(castlingMoves);
+		for (Move castlingMove : castlingMoves) {
+			if (castlingMove.to() == to) {
+				return true;
+			}
 		}
-	}
-	cout << '\n';
-}
-
-const ChessPiece* ChessBoard::isCheck(Pos kingPos) {
-	//check if king can be taken
-	return ChessPiece::canBeTaken(kingPos, (const ChessPiece* (*)[8]) board, sideToMove);
-}
-
-bool ChessBoard::isCheckmate(Pos kingPos, const ChessPiece* checkingPiece) {
-	//check if king can move 
-	if (kingCanMove(kingPos)) {
 		return false;
 	}
-	//check if attacking piece can be taken
-	if (canTakeAttacker(checkingPiece)) {
+	//and other moves must be to one of the piece's moves, not leaving the king in check
+	if (move.type() != Move::EN_PASSANT && !(pieceMoves(from) & squareBB(to))) {
 		return false;
 	}
-	//check if attacking piece can be blocked if it is not a knight
-	if (checkingPiece->getSymbol() != 'N' && checkingPiece->getSymbol() != 'n'
-			&& canBlockAttacker(kingPos, checkingPiece)) {
-			return false;
-	}
-	//if all checks pass, return true
-	return true;
+	return isLegal(move);
 }
 
-bool ChessBoard::kingCanMove(Pos kingPos) {
-	//check each square around the king
-	for (int rowStep = -1; rowStep <= 1; rowStep++) {
-		for (int colStep = -1; colStep <= 1; colStep++) {
-			//don't check the square that the king is in
-			if (rowStep == 0 && colStep == 0) {
-				continue;
-			}
-			int row = kingPos.row + rowStep;
-			int col = kingPos.col + colStep;
-			Pos dest = Pos(row, col);
-			//check if the proposed square is on the board
-			if (row < 0 || row > 7 || col < 0 || col > 7) {
-				continue;
-			}
-			//check if the king can move to the proposed square
-			if (tryValidMove(board[kingPos.row][kingPos.col], kingPos, dest)) {
-				return true;	
-			}
-		}
-	}
-	//if the king cannot move to any of the proposed squares, return false
-	return false;
-}
-
-bool ChessBoard::canTakeAttacker(const ChessPiece* checkingPiece) {
-	//check if checkingPiece can be captured
-	const ChessPiece* takingPiece = ChessPiece::canBeTaken(checkingPiece->getPos(), 
-									(const ChessPiece* (*)[8])board, sideToMove, 'K');
-	//if there is a piece that can take the checkingPiece
-	if (takingPiece) {
-		Pos src = takingPiece->getPos();
-		Pos dest = checkingPiece->getPos();
-		//check if taking the checkingPiece is a valid move
-		if (tryValidMove((ChessPiece*)takingPiece, src, dest)) {
-			return true;
-		}
-	}
-	//if checkingPiece cannot be taken, return false
-	return false;
-}
-
-bool ChessBoard::canBlockAttacker(Pos kingPos, const ChessPiece* checkingPiece) {
-	int rowStep = 0, colStep = 0;
-	//if the path is horizontal, only set colStep
-	if (checkingPiece->getPos().row == kingPos.row) {
-		colStep = (checkingPiece->getPos().col > kingPos.col) ? 1 : -1;
-	}
-	//if the path is vertical, only set rowStep
-	if (checkingPiece->getPos().col == kingPos.col) {
-		rowStep = (checkingPiece->getPos().row > kingPos.row) ? 1 : -1;
-	}
-	//if the path is diagonal, set rowStep and colStep
-	if (abs(checkingPiece->getPos().row - kingPos.row) 
-			== abs(checkingPiece->getPos().col - kingPos.col)) {
-		rowStep = (checkingPiece->getPos().row > kingPos.row) ? 1 : -1;
-		colStep = (checkingPiece->getPos().col > kingPos.col) ? 1 : -1;
-	}
-	//for each square in the path
-	for (int row = kingPos.row + rowStep, col = kingPos.col + colStep; 
-			 row != checkingPiece->getPos().row || col != checkingPiece->getPos().col; 
-			 row += rowStep, col += colStep) {
-		//check if there is a piece that can move to the square
-		const ChessPiece* takingPiece = ChessPiece::canBeTaken(Pos(row, col), 
-										(const ChessPiece* (*)[8])board, sideToMove, 'K');
-		//if there is a piece that can block the path
-		if (takingPiece) {
-			Pos src(takingPiece->getPos().row, takingPiece->getPos().col);
-			Pos dest(row, col);
-			//check if blocking the path is a valid move
-			if (tryValidMove((ChessPiece*)takingPiece, src, dest)) {
-				return true;
-			}	
-		}
-	}
-	//if path cannot be blocked by a piece, return false
-	return false;
-}
-
-void ChessBoard::updateCastlingState(ChessPiece* piece) {
-	const char* remove = NULL;
-	//based on the FEN symbol of the piece, select castling availability to remove
-	switch(piece->getSymbol()) {
-		case 'K':
-			remove = "KQ";
-			break;
-		case 'k':
-			remove = "kq";
-			break;
-		case 'R':
-			if (piece->getPos().col == 7) {
-				remove = "K";
-			} else if (piece->getPos().col == 0) {
-				remove = "Q";
-			}
-			break;
-		case 'r':
-			if (piece->getPos().col == 7) {
-				remove = "k";
-			} else if (piece->getPos().col == 0) {
-				remove = "q";
-			}
-			break;
-	}
-	//if there is castling availability to remove
-	if (remove) {
-		//set up a new char array
-		char* newState = new char[4];
-		int index = 0;
-		bool match = false;
-		for (const char* c = castlingState; *c != '\0'; c++) {
-			for (const char* r = remove; *r != '\0'; r++) {
-				//check if castling availability is in the remove char array
-				if (*c == *r) {
-					match = true;
-					break;
-				}
-			}
-			//if not in remove char array, add to the new char array
-			if (!match) {
-				newState[index] = *c;
-				index++;
-			}
-			match = false;
-		}
-		//add the null terminator
-		newState[index] = '\0';
-		//if all castling availability has been removed, set it to '-'
-		if (newState[0] == '\0') {
-			newState = (char*)"-";
-		}
-		//set castlingState to the new char array
-		castlingState = newState;
+const ChessPiece* ChessBoard::pieceAt(Pos pos) const {
+	uint8_t code = board[pos.index()];
+	//the shared ChessPiece of the colour and type the code holds
+	if (code) {
+		return ChessPiece::flyweight(static_cast<COLOUR>(code >> 3),
+									 static_cast<PIECE>((code & 7) - 1));
 	}
+	return NULL;
 }
 
-void ChessBoard::resetIsCastling(ChessPiece* piece) {
-	//if the piece is a king, reset isCastling to false
-	switch(piece->getSymbol()) {
-		case 'K':
-			((King*)piece)->isCastling = false;
-			break;
-		case 'k':
-			((King*)piece)->isCastling = false;
-			break;
-	}
+void ChessBoard::setSquare(int square, uint8_t code) {
+	board[square] = code;
 }
 
-bool ChessBoard::boardHasValidMove(COLOUR sideToMove) {
-	//for each square of the board
-	for (int row = 0; row < 8; row++) {
-		for (int col = 0; col < 8; col++) {
-			ChessPiece* piece = board[row][col];
-			//check if there is a player's piece there and whether it has any valid moves
-			if (piece && piece->getColour() == sideToMove && pieceHasValidMove(piece)) {
-				return true;
-			}
-		}
-	}
-	//if there are no valid moves for any of the player's pieces, return false
-	return false;
+void ChessBoard::makeMove(Move move) {
+	STATS_COUNT(MAKE_MOVE);
+	int from = move.from(), to = move.to();
+	//remove any piece taken beside the source en passant
+	if (move.type() == Move::EN_PASSANT) {
+		setSquare((sideToMove == WHITE) ? to + 8 : to - 8, 0);
+	}
+	//a castling king's rook moves to the square the king passes over
+	if (move.type() == Move::CASTLING) {
+		int rookSquare = (to > from) ? to + 1 : to - 2;
+		setSquare((from + to) / 2, board[rookSquare]);
+		setSquare(rookSquare, 0);
+	}
+	//a piece taken on the destination is overwritten
+	setSquare(to, board[from]);
+	setSquare(from, 0);
+	//a promoting pawn is replaced by the new piece
+	if (move.type() == Move::PROMOTION) {
+		setSquare(to, pieceCode(sideToMove, move.promotion()));
+	}
+	//update the Bitboards and state, saving the state before the move
+	StateInfo state;
+	doMove(move, state);
+	//reserve the history on the first move, so a board that only loads positions does
+	//not allocate, and later moves do not until the game is longer than MAX_HISTORY
+	if (history.capacity() == 0) {
+		history.reserve(MAX_HISTORY);
+	}
+	history.push_back(state);
+	legalMoveCount = -1;
 }
 
-bool ChessBoard::pieceHasValidMove(ChessPiece* piece) {
-	//for each square of the board
-	for (int row = 0; row < 8; row++) {
-		for (int col = 0; col < 8; col++) {
-			//check if the piece can move to the square
-			if (tryValidMove(piece, piece->getPos(), Pos(row, col))) {
-				return true;
-			}
+void ChessBoard::unmakeMove() {
+	STATS_COUNT(UNMAKE_MOVE);
+	const StateInfo& state = history.back();
+	Move move = state.move;
+	int from = move.from(), to = move.to();
+	//restore the Bitboards and state before the move
+	undoMove(state);
+	//put back the pawn a piece was promoted from
+	if (move.type() == Move::PROMOTION) {
+		setSquare(to, pieceCode(sideToMove, PAWN));
+	}
+	setSquare(from, board[to]);
+	setSquare(to, 0);
+	//put back a castling king's rook
+	if (move.type() == Move::CASTLING) {
+		setSquare((to > from) ? to + 1 : to - 2, board[(from + to) / 2]);
+		setSquare((from + to) / 2, 0);
+	}
+	//put back the piece taken
+	if (state.captured != -1) {
+		COLOUR opponent = static_cast<COLOUR>(sideToMove ^ WHITE ^ BLACK);
+		int takenSquare = to;
+		if (move.type() == Move::EN_PASSANT) {
+			takenSquare = (sideToMove == WHITE) ? to + 8 : to - 8;
 		}
+		setSquare(takenSquare, pieceCode(opponent, static_cast<PIECE>(state.captured)));
 	}
-	//if the piece cannot move to any square, return false
-	return false;
+	history.pop_back();
+	legalMoveCount = -1;
 }
 
-std::ostream& operator << (std::ostream& output, const ChessBoard::COLOUR& colour) {	
-	//setup an array of strings corresponding to the COLOURS enum
-	const char* colours[] = {"Black", "White"};
-	//print enum using COLOUR as index
-	return output << colours[colour];
+void ChessBoard::checkGameState(MoveResult& result) const {
+	//a player with no legal moves is in checkmate if they are in check, else stalemate
+	//(this caches the legal moves, so the next move submitted is a lookup)
+	bool noMoves = !hasLegalMove();
+	result.check = checkers;
+	result.checkmate = checkers && noMoves;
+	result.stalemate = !checkers && noMoves;
 }
 
 std::ostream& operator << (std::ostream& output, const ChessBoard& board) {
@@ -494,11 +631,12 @@ std::ostream& operator << (std::ostream& output, const ChessBoard& board) {
 		output << 8 - rank << " ";
 		for (int file = 0; file < 8; file++) {
 			//print piece on board or '.' if there is no piece
-			if (board.board[rank][file] == NULL) {
+			const ChessPiece* piece = board.pieceAt(Pos(rank, file));
+			if (piece == NULL) {
 				output << ". ";
 				continue;
 			}
-			output << *board.board[rank][file] << " ";
+			output << *piece << " ";
 		} 
 		output << endl;
 	}
@@ -512,14 +650,15 @@ std::ostream& operator << (std::ostream& output, const ChessBoard& board) {
 }
 
 void ChessBoard::destruct () {
-	//for each square of the board
-	for (int rank = 0; rank < 8; rank++) {
-		for (int file = 0; file < 8; file++) {
-			//free the pointer in the square
-			delete board[rank][file];
-			board[rank][file] = NULL;
-		}
-	}
+	//empty each square of the board
+	for (int square = 0; square < 64; square++) {
+		board[square] = 0;
+	}
+	history.clear();
+	startPly = 0;
+	legalMoveCount = -1;
+	//clear the Bitboards and state
+	Position::operator=(Position());
 }
 
 ChessBoard::~ChessBoard() {
@@ -4,46 +4,132 @@
 #define CHESSBOARD_H
 
 #include <iostream>
+#include <vector>
+#include "Bitboard.h"
+#include "MoveResult.h"
 #include "Pos.h"
+#include "Position.h"
 
 /******************* Class ChessBoard *******************/
 
 class ChessPiece;
+class MoveObserver;
+struct PackedPosition;
+struct StateInfo;
 
-class ChessBoard {
+/* A game of chess: a Position with a 1-byte piece code on each square, and the moves
+ * made so far (copying a ChessBoard into a Position gives a plain copy of its position)
+ */
+class ChessBoard : public Position {
 	public:
-		/* Represents the colour of the players and pieces
-		 *
-		 * @value BLACK: black player or black piece
-		 * @value WHITE: white player or white piece
-		 */
-		enum COLOUR {BLACK, WHITE};
-		
 		/* Creates an instance of an empty ChessBoard
 		 */
 		ChessBoard();
 		
-		/* Populates the ChessBoard and its state based on a FEN string
+		/* Represents whether a FEN string was loaded, or which of its fields is invalid
+		 *
+		 * @value LOADED: the FEN string was loaded
+		 * @value INVALID_BOARD: the pieces are not 8 rows of 8 squares, or a pawn is on
+		 *						 the first or last row
+		 * @value INVALID_KINGS: a player does not have exactly one king
+		 * @value INVALID_SIDE_TO_MOVE: the active colour is not 'w' or 'b'
+		 * @value INVALID_CASTLING: the castling availability is not '-' or some of "KQkq"
+		 * @value INVALID_EN_PASSANT: the en passant square is not '-' or a square a pawn
+		 *							  of the opponent has just passed over
+		 * @value INVALID_HALFMOVE_CLOCK: the halfmove clock is not a number up to 65535
+		 * @value INVALID_FULLMOVE_NUMBER: the fullmove number is not a number from 1 to
+		 *								   1000000, or is followed by more text
+		 */
+		enum FEN_STATUS {LOADED, INVALID_BOARD, INVALID_KINGS, INVALID_SIDE_TO_MOVE,
+						 INVALID_CASTLING, INVALID_EN_PASSANT, INVALID_HALFMOVE_CLOCK,
+						 INVALID_FULLMOVE_NUMBER};
+
+		static const int MAX_FEN_LENGTH = 100; //chars toFEN can write, including the '\0'
+		static const int MAX_HISTORY = 1024; //moves the history has room for once the first
+											 //move is made, before makeMove allocates again
+
+		/* Populates the ChessBoard and its state based on a FEN string, printing whether
+		 * it was loaded, without allocating. The castling availability, en passant
+		 * square, halfmove clock and fullmove number can be left out, and default to
+		 * "- - 0 1". Castling rights whose king or rook is not on its start square are
+		 * dropped, as is an en passant square no pawn can take on.
+		 * If the FEN string is invalid, the ChessBoard is left empty
 		 * 
 		 * @param FENstring: ChessBoard state in Forsyth-Edwards Notation 
+		 * @returns: LOADED, or the first field of the FEN string that is invalid
 		 */
-		void loadState(const char* FENstring);
+		FEN_STATUS loadState(const char* FENstring);
+
+		/* Writes the ChessBoard and its state as a FEN string with all six fields,
+		 * without allocating
+		 *
+		 * @param FENstring: set to the FEN string, at least MAX_FEN_LENGTH chars long
+		 * @returns: the length of the FEN string, not including the '\0'
+		 */
+		int toFEN(char* FENstring) const;
+
+		/* Populates the ChessBoard and its state from a packed record, without printing
+		 * or allocating. Castling rights are dropped and the en passant square is
+		 * checked as in loadState. If the record is invalid, the ChessBoard is left empty
+		 *
+		 * @param packed: the packed record
+		 * @returns: LOADED, or the first field of the record that is invalid, in the
+		 *			 order of a FEN string
+		 */
+		FEN_STATUS loadPacked(const PackedPosition& packed);
+
+		/* Packs the ChessBoard and its state into a record, which loadPacked loads back
+		 * exactly
+		 *
+		 * @param packed: set to the packed record
+		 * @returns: whether the position fits, which needs at most 32 pieces
+		 */
+		bool toPacked(PackedPosition& packed) const;
 		
 		/* Initiates checks to see whether a move is valid, makes the move,
-		 * and checks if the move results in a check, checkmate or stalemate
+		 * and checks if the move results in a check, checkmate or stalemate,
+		 * printing the result and the board
 		 *
 		 * @param src: location of piece to move represented by rank and file
 		 * @param dest: location to move to represented by rank and file
 		 */
 		void submitMove(const char* src, const char* dest);
 
-		/* Overloads the << operator to print a COLOUR
+		/* Makes a move if it is valid without printing anything, and checks if it
+		 * results in a check, checkmate or stalemate
 		 *
-		 * @param std::ostream&: the output stream to write to
-		 * @param ChessBoard&: COLOUR to be printed
-		 * @returns: the output stream
+		 * @param src: location of piece to move represented by rank and file
+		 * @param dest: location to move to represented by rank and file
+		 * @param observer: MoveObserver to pass the result to, or NULL
+		 * @returns: the outcome of the move
 		 */
-		friend std::ostream& operator << (std::ostream&, const COLOUR&);
+		MoveResult submitMove(const char* src, const char* dest, MoveObserver* observer);
+
+		/* Makes a legal move, moving the ChessPieces and saving what is needed to unmake
+		 * it on the history stack. The first move made on the ChessBoard reserves room
+		 * for MAX_HISTORY moves, and later moves only allocate in a longer game
+		 *
+		 * @param move: a move from generateLegalMoves
+		 */
+		void makeMove(Move move);
+
+		/* Unmakes the last move made, restoring the ChessBoard and its state
+		 */
+		void unmakeMove();
+
+		/* Getter for the piece on a square
+		 *
+		 * @param pos: position of the square
+		 * @returns: the piece on the square, or NULL if it is empty
+		 */
+		const ChessPiece* pieceAt(Pos pos) const;
+
+		/* Checks whether the player who has the move has a legal move, using the cached
+		 * legal moves of the position
+		 *
+		 * @returns: whether there is a legal move
+		 */
+		bool hasLegalMove() const;
 
 		/* Overloads the << operator to display the ChessBoard
 		 *
@@ -58,140 +144,147 @@ class ChessBoard {
 		virtual ~ChessBoard();
 
 	private:
-		ChessPiece* board[8][8]; //2D array representing the ChessBoard and its pieces
-		COLOUR sideToMove; //Player who has the move
-		const char* castlingState; //State of castling availability
-		Pos kingPos[2]; //Position of kings (black at index 0, white at index 1)
+		uint8_t board[64]; //code of the piece on each square index (see pieceCode), or 0 if empty
+		std::vector<StateInfo> history; //state before each move made, for unmakeMove, empty
+										//until the first move reserves MAX_HISTORY
+		int startPly; //half moves from the start of the game to the position loaded
+		mutable Bitboard legalTargets[64]; //squares the piece on each square can legally
+										   //move to, while legalMoveCount is not -1
+		mutable int legalMoveCount; //number of legal moves, or -1 if legalTargets is stale
 
-		/* Dynamically creates a specific ChessPiece type based on a FEN char
+		/* Sets the piece on a square of the board array, leaving the Bitboards unchanged
 		 *
-		 * @param pos: position of ChessPiece on the ChessBoard
-		 * @param FENchar: ChessPiece in Forsyth-Edwards Notation
-		 * @returns: a pointer to the created ChessPiece
+		 * @param square: square index to set
+		 * @param code: code of the piece to put on the square, or 0 to empty it
 		 */
-		ChessPiece* makePiece(Pos pos, char FENchar);
+		void setSquare(int square, uint8_t code);
 
-		/* Populates a ChessBoard with ChessPieces by incrementing FENstring pointer
-		 * 
-		 * @param row: row on the ChessBoard
-		 * @param col: column on the ChessBoard 
-		 * @param FENstring: ChessBoard state in Forsyth-Edwards Notation
-		 * @returns: the updated FENstring pointer
-		 */
-		const char* loadBoard(int& row, int& col, const char* FENstring);
-		
-		/* Sets sideToMove with the active colour from FENstring
+		/* Gets the code a piece is stored as in the board array, colour * 8 + type + 1
 		 *
-		 * @param FENstring: active colour and castling availability of the ChessBoard 
-		 *					 state in Forsyth-Edwards Notation
-		 * @returns: the updated FENstring pointer
+		 * @param colour: colour of the piece
+		 * @param type: type of the piece
+		 * @returns: the code of the piece
 		 */
-		const char* getSideToMove(const char* FENstring);
+		static uint8_t pieceCode(COLOUR colour, PIECE type);
 
-		/* Moves a piece from source to destination
+		/* Gets the code of the piece a FEN char represents
 		 *
-		 * @param src: position of the source
-		 * @param dest: position of the destination
-		 * @returns: ChessPiece or NULL at the destination
-		 */
-		ChessPiece* movePiece(Pos src, Pos dest);
-		
-		/* Reverts a move from the original destination to the original source
-		 *
-		 * @param dest_o: original destination a piece moved to
-		 * @param src_o: original source a piece moved from
-		 * @param takenPiece: piece that was at the original destination
+		 * @param FENchar: ChessPiece in Forsyth-Edwards Notation
+		 * @returns: the code of the piece, or 0 if FENchar is not a piece
 		 */
-		void undoMove(Pos dest_o, Pos src_o, ChessPiece* takenPiece);
+		static uint8_t pieceCode(char FENchar);
 
-		/* Evaluates whether a move is valid
+		/* Populates a ChessBoard with pieces from the first field of FENstring
 		 * 
-		 * @param piece: piece to move
-		 * @param src: source position to move from
-		 * @param dest: destination position to move to
-		 * @returns: whether move is valid
+		 * @param FENstring: ChessBoard state in Forsyth-Edwards Notation
+		 * @returns: the FENstring pointer after the field, or NULL if it is invalid
 		 */
-		bool tryValidMove(ChessPiece* piece, Pos src, Pos dest);
-
-		/* Changes the player/colour that has the move
+		const char* loadBoard(const char* FENstring);
+		
+		/* Populates a ChessBoard with the pieces of a packed record
+		 *
+		 * @param packed: the packed record
+		 * @returns: whether the pieces are valid
 		 */
-		void changeSides();
+		bool loadPackedBoard(const PackedPosition& packed);
 
-		/* Moves a piece based on input from submitMove and prints the move
-		 * 
-		 * @param src: source position in rank and file form
-		 * @param srcPos: source position in row and column form
-		 * @param dest: destination position in rank and file form
-		 * @param destPos: destination position in row and column form
+		/* Puts a piece on a square of the board array and the Bitboards
+		 *
+		 * @param square: square index of the piece
+		 * @param code: code of the piece (see pieceCode)
+		 * @returns: whether the code is a piece that can stand on the square
 		 */
-		void makeMove(const char* src, Pos srcPos, const char* dest, Pos destPos);
+		bool placePiece(int square, uint8_t code);
 
-		/* Checks whether player is in check, checkmate or stalemate
+		/* Sets sideToMove with the active colour from FENstring
+		 *
+		 * @param FENstring: active colour of the ChessBoard state in Forsyth-Edwards
+		 *					 Notation
+		 * @returns: the FENstring pointer after the field, or NULL if it is invalid
 		 */
-		void checkGameState();
+		const char* loadSideToMove(const char* FENstring);
 
-		/* Checks whether a king is in check
+		/* Sets castlingRights with the castling availability from FENstring
 		 *
-		 * @param kingPos: position of the king
-		 * @returns: piece that can take the king
+		 * @param FENstring: castling availability of the ChessBoard state in
+		 *					 Forsyth-Edwards Notation
+		 * @returns: the FENstring pointer after the field, or NULL if it is invalid
 		 */
-		const ChessPiece* isCheck(Pos kingPos);
-		
-		/* Checks whether a player is in checkmate
+		const char* loadCastlingRights(const char* FENstring);
+
+		/* Sets epSquare with the en passant square from FENstring
 		 *
-		 * @param kingPos: position of the player's king
-		 * @param checkingPiece: piece that can take the player's king
-		 * @returns: whether player is in checkmate
+		 * @param FENstring: en passant square of the ChessBoard state in Forsyth-Edwards
+		 *					 Notation
+		 * @returns: the FENstring pointer after the field, or NULL if it is invalid
 		 */
-		bool isCheckmate(Pos kingPos, const ChessPiece* checkingPiece);
+		const char* loadEnPassant(const char* FENstring);
 
-		/* Checks whether a player's king can move
+		/* Sets castlingRights, dropping any right whose king or rook is not on its start
+		 * square
 		 *
-		 * @param kingPos: position of the player's king
-		 * @returns: whether the king has a valid move
+		 * @param rights: CASTLING_RIGHT flags to set
 		 */
-		bool kingCanMove(Pos);
+		void setCastlingRights(int rights);
 
-		/* Checks whether a piece's attacker can be taken
+		/* Sets epSquare, keeping it only if a pawn of the player with the move can take
+		 * on it, as doMove does
 		 *
-		 * @param checkingPiece: the attacking piece
-		 * @returns: whether the attacking piece can be taken
+		 * @param square: the en passant square, or -1 if there is none
+		 * @returns: whether the square is behind a pawn of the opponent that has just
+		 *			 moved two squares, or is -1
 		 */
-		bool canTakeAttacker(const ChessPiece* checkingPiece);
+		bool setEnPassant(int square);
 
-		/* Checks whether the path from a king and its attacker can be blocked
+		/* Reads a whole number field from FENstring
 		 *
-		 * @param kingPos: position of the king
-		 * @param checkingPiece: the piece that is attacking the king
-		 * @returns: whether the path between checkingPiece and king can be blocked
+		 * @param FENstring: the field in Forsyth-Edwards Notation
+		 * @param min: smallest value allowed
+		 * @param max: largest value allowed
+		 * @param value: set to the number
+		 * @returns: the FENstring pointer after the field, or NULL if it is invalid
 		 */
-		bool canBlockAttacker(Pos kingPos, const ChessPiece* checkingPiece);
+		static const char* loadNumber(const char* FENstring, int min, int max, int& value);
 
-		/* Update the castling availability based on which piece is moving
+		/* Sets the clocks and works out the hash, checks and pins of a loaded position
 		 *
-		 * @param piece: the piece that is moving
+		 * @param halfmoves: the halfmove clock
+		 * @param fullmoves: the fullmove number
+		 */
+		void finishLoad(int halfmoves, int fullmoves);
+
+		/* Fills legalTargets with the legal moves of the position, unless they are
+		 * already cached. makeMove, unmakeMove and loading a position make them stale,
+		 * and checkGameState caches them again after each move submitted
 		 */
-		void updateCastlingState(ChessPiece* piece);
+		void cacheLegalMoves() const;
 
-		/* Reset the isCastling member of a king after a move
+		/* Evaluates whether a move is valid, working out whether it is castling, en
+		 * passant or a promotion (a pawn reaching the last row is promoted to a queen).
+		 * The move is looked up in the cached legal moves if there are any, and
+		 * otherwise checked on its own
 		 *
-		 * @param piece: the piece hat has moved
+		 * @param piece: piece to move
+		 * @param src: source position to move from
+		 * @param dest: destination position to move to
+		 * @param move: set to the move if it is valid
+		 * @returns: whether move is valid
 		 */
-		void resetIsCastling(ChessPiece* piece);
+		bool tryValidMove(const ChessPiece* piece, Pos src, Pos dest, Move& move) const;
 
-		/* Checks whether there are any valid moves for a player on the board
+		/* Makes a move based on input from submitMove if it is valid
 		 *
-		 * @param sideToMove: which player to check for
-		 * @returns: whether the player's pieces have any valid moves
+		 * @param src: source position in rank and file form
+		 * @param dest: destination position in rank and file form
+		 * @param result: set to the outcome of the move
 		 */
-		bool boardHasValidMove(COLOUR sideToMove);
+		void playMove(const char* src, const char* dest, MoveResult& result);
 
-		/* Checks whether a piece has any valid moves
+		/* Checks whether player is in check, checkmate or stalemate
 		 *
-		 * @param piece: the piece to check
-		 * @returns: whether the piece has any square to move to
+		 * @param result: check, checkmate and stalemate are set in it
 		 */
-		bool pieceHasValidMove(ChessPiece* piece);
+		void checkGameState(MoveResult& result) const;
 
 		/* Empties the ChessBoard
 		 */
@@ -1,10 +1,113 @@
+#include"Bench.h"
 #include"ChessBoard.h"
+#include"Search.h"
 
+#include<cstdlib>
+#include<cstring>
 #include<iostream>
+#include<thread>
 
 using std::cout;
 
-int main() {
+/* Finds the best move of a position for "chess search [-d depth] [-n nodes]
+ * [-t milliseconds] [-H megabytes] [-j threads] [FEN]", printing each iteration then the
+ * best move
+ *
+ * @param argc: number of arguments after "search"
+ * @param argv: the arguments after "search"
+ * @returns: the exit status
+ */
+static int search(int argc, char* argv[]) {
+	SearchLimits limits = {0, 0, 0};
+	size_t hashMegabytes = 16;
+	int threads = 1;
+	const char* FENstring = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+	int arg = 0;
+	for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+		if (strcmp(argv[arg], "-d") == 0) {
+			limits.depth = atoi(argv[arg + 1]);
+		} else if (strcmp(argv[arg], "-n") == 0) {
+			limits.nodes = strtoull(argv[arg + 1], NULL, 10);
+		} else if (strcmp(argv[arg], "-t") == 0) {
+			limits.milliseconds = strtoull(argv[arg + 1], NULL, 10);
+		} else if (strcmp(argv[arg], "-H") == 0) {
+			hashMegabytes = strtoull(argv[arg + 1], NULL, 10);
+		} else if (strcmp(argv[arg], "-j") == 0) {
+			threads = atoi(argv[arg + 1]);
+		} else {
+			break;
+		}
+	}
+	if (arg < argc) {
+		FENstring = argv[arg++];
+	}
+	if (arg < argc || limits.depth < 0 || threads < 1) {
+		std::cerr << "Usage: chess search [-d depth] [-n nodes] [-t milliseconds] [-H megabytes]"
+				  << " [-j threads] [FEN]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	//with no limit given, search to a fixed depth
+	if (!limits.depth && !limits.nodes && !limits.milliseconds) {
+		limits.depth = 6;
+	}
+
+	//load the position without printing the load message
+	ChessBoard board;
+	std::streambuf* output = cout.rdbuf(NULL);
+	ChessBoard::FEN_STATUS status = board.loadState(FENstring);
+	cout.rdbuf(output);
+	if (status != ChessBoard::LOADED) {
+		std::cerr << "Invalid FEN string: " << FENstring << std::endl;
+		return EXIT_FAILURE;
+	}
+	TranspositionTable table(hashMegabytes);
+	Search engine(board, table);
+	SearchResult result = engine.run(limits, &cout, threads);
+	cout << "Best move: ";
+	if (result.pvLength) {
+		cout << result.bestMove;
+	} else {
+		cout << "none";
+	}
+	cout << "\nDepth: " << result.depth << "\nNodes searched: " << result.nodes
+		 << "\nTotal time (ms): " << result.milliseconds << "\nNodes/second: "
+		 << result.nodesPerSecond << std::endl;
+	return 0;
+}
+
+int main(int argc, char* argv[]) {
+
+	//"chess bench [depth] [threads]" times the engine instead of playing the games
+	if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+		int depth = (argc > 2) ? atoi(argv[2]) : 6;
+		int threads = (argc > 3) ? atoi(argv[3]) : 1;
+		if (depth < 1 || threads < 1) {
+			std::cerr << "Usage: " << argv[0] << " bench [depth] [threads]" << std::endl;
+			return EXIT_FAILURE;
+		}
+		bench(depth, threads, 16);
+		return 0;
+	}
+
+	//"chess search [-d depth] [-n nodes] [-t milliseconds] [-H megabytes] [-j threads]
+	//[FEN]" finds the best move
+	if (argc > 1 && strcmp(argv[1], "search") == 0) {
+		return search(argc - 2, argv + 2);
+	}
+
+	//"chess scaling [threads] [depth]" times searches to a depth with more and more threads
+	if (argc > 1 && strcmp(argv[1], "scaling") == 0) {
+		//by default up to every CPU the system reports, which can be 0 if it is not known
+		unsigned cpus = std::thread::hardware_concurrency();
+		int threads = (argc > 2) ? atoi(argv[2]) : (cpus ? int(cpus) : 1);
+		int depth = (argc > 3) ? atoi(argv[3]) : 7;
+		if (threads < 1 || depth < 1) {
+			std::cerr << "Usage: " << argv[0] << " scaling [threads] [depth]" << std::endl;
+			return EXIT_FAILURE;
+		}
+		searchScaling(threads, depth, 64);
+		return 0;
+	}
 
 	cout << "========================\n";
 	cout << "Testing the Chess Engine\n";
@@ -4,60 +4,42 @@
 #define CHESSPIECE_H
 
 #include "ChessBoard.h"
-#include "Moves.h"
-#include "Pos.h"
 
 /***************** Superclass ChessPiece *****************/ 
 
+/* A piece of a colour and type, shared by every square it stands on (see flyweight).
+ * Rook, Knight, Bishop, Queen, King and Pawn only set the name, type and icon, since
+ * moves are validated by Position
+ */
 class ChessPiece {
 	public:
 		/* Creates an instance of ChessPiece
 		 *
-		 * @param _pos: position of the piece
 		 * @param _colour: colour of the player
 		 */
-		ChessPiece(Pos _pos, ChessBoard::COLOUR _colour);
+		ChessPiece(ChessBoard::COLOUR _colour);
 
-		/* Getter for a piece's colour
+		/* Gets the shared, unchanging instance of a piece, so no piece is ever created
+		 * for a square
 		 *
-		 * @returns: the piece's colour
+		 * @param colour: colour of the piece
+		 * @param type: type of the piece
+		 * @returns: the piece
 		 */
-		ChessBoard::COLOUR getColour() const;
+		static const ChessPiece* flyweight(ChessBoard::COLOUR colour, ChessBoard::PIECE type);
 
-		/* Getter for a piece's FEN symbol
-		 *
-		 * @returns: the piece's FEN symbol
-		 */
-		char getSymbol() const;
-		
-		/* Getter for a piece's position
-		 *
-		 * @returns: the piece's position
-		 */
-		Pos getPos() const;
-		
-		/* Setter for a piece's position
+		/* Getter for a piece's colour
 		 *
-		 * @param newPos: the position to set the piece's position to
+		 * @returns: the piece's colour
 		 */
-		void setPos(Pos newPos);
+		ChessBoard::COLOUR getColour() const;
 
-		/* Checks whether a piece can be taken by the opponent
+		/* Getter for a piece's type
 		 *
-		 * @param pos: position of piece to check
-		 * @param board: the ChessBoard
-		 * @param sideToMove: which player has the move
-		 * @param except: FEN representation of piece that is not allowed to move
-		 *				  (takes in capital letters only)
-		 * @returns: opponent's piece that can take the piece, otherwise NULL
+		 * @returns: the piece's type
 		 */
-		static const ChessPiece* canBeTaken(Pos pos, const ChessPiece* board[][8], 
-											ChessBoard::COLOUR sideToMove, char except='-');
+		ChessBoard::PIECE getType() const;
 		
-		/* Checks whether the path from source to destination is valid for a piece
-		 */
-		virtual bool isValidMove(Pos src, Pos dest, const ChessPiece* board[][8]) = 0;
-
 		/* Overloads the << operator to display a piece's icon
 		 *
 		 * @param std::ostream&: the output stream to write to
@@ -76,51 +58,13 @@ class ChessPiece {
 
 		/* Destructor for ChessPiece
 		 */
-		virtual ~ChessPiece();
+		~ChessPiece();
 
 	protected:
-		Pos pos; //position of the ChessPiece on the ChessBoard
 		ChessBoard::COLOUR pieceColour; //colour of the ChessPiece
 		const char* icon; //icon of the ChessPiece
 		const char* name; //name of the ChessPiece
-		char symbol; //FEN representation of the ChessPiece
-
-	private:
-		/* Checks whether a piece at pos can be taken horizontally
-		 *
-		 * @param pos: position of the piece to check
-		 * @param board: the ChessBoard
-		 * @param sideToMove: which player has the move
-		 * @param except: FEN representation of piece that is not allowed to move
-		 *				  (takes in capital letters only)
-		 * @returns: opponent's piece that can take the piece, otherwise NULL
-		 */
-		static const ChessPiece* checkHorizontal(Pos pos, const ChessPiece* board[][8],
-											ChessBoard::COLOUR sideToMove, char except);
-
-		/* Checks whether a piece at pos can be taken vertically 
-		 *
-		 * @param pos: position of the piece to check
-		 * @param board: the ChessBoard
-		 * @param sideToMove: which player has the move
-		 * @param except: FEN representation of piece that is not allowed to move
-		 *				  (takes in capital letters only)
-		 * @returns: opponent's piece that can take the piece, otherwise NULL
-		 */
-		static const ChessPiece* checkVertical(Pos pos, const ChessPiece* board[][8],
-											ChessBoard::COLOUR sideToMove, char except);
-
-		/* Checks whether a piece at pos can be taken diagonally 
-		 *
-		 * @param pos: position of the piece to check
-		 * @param board: the ChessBoard
-		 * @param sideToMove: which player has the move
-		 * @param except: FEN representation of piece that is not allowed to move
-		 *				  (takes in capital letters only)
-		 * @returns: opponent's piece that can take the piece, otherwise NULL
-		 */
-		static const ChessPiece* checkDiagonal(Pos pos, const ChessPiece* board[][8],
-											ChessBoard::COLOUR sideToMove, char except);
+		ChessBoard::PIECE type; //type of the ChessPiece
 };
 
 /******************** Subclass Rook **********************/
@@ -129,19 +73,9 @@ class Rook: public ChessPiece {
 	public:
 		/* Creates an instance of Rook
 		 *
-		 * @param _pos: position of the piece
 		 * @param _colour: colour of the piece
 		 */
-		Rook(Pos _pos, ChessBoard::COLOUR _colour);
-
-		/* Checks whether the path from source to destination is valid
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @returns: whether the path is valid
-		 */
-		bool isValidMove(Pos src, Pos dest, const ChessPiece* board[][8]) override;
+		Rook(ChessBoard::COLOUR _colour);
 };
 
 /******************* Subclass Knight *********************/
@@ -150,19 +84,9 @@ class Knight: public ChessPiece {
 	public:
 		/* Creates an instance of Knight
 		 *
-		 * @param _pos: position of the piece
 		 * @param _colour: colour of the piece
 		 */
-		Knight(Pos, ChessBoard::COLOUR);
-
-		/* Checks whether the path from source to destination is valid
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @returns: whether the path is valid
-		 */
-		bool isValidMove(Pos src, Pos dest, const ChessPiece* board[][8]) override;
+		Knight(ChessBoard::COLOUR _colour);
 };
 
 /******************* Subclass Bishop *********************/
@@ -171,19 +95,9 @@ class Bishop: public ChessPiece {
 	public:
 		/* Creates an instance of Bishop
 		 *
-		 * @param _pos: position of the piece
 		 * @param _colour: colour of the piece
 		 */
-		Bishop(Pos, ChessBoard::COLOUR);
-
-		/* Checks whether the path from source to destination is valid
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @returns: whether the path is valid
-		 */
-		bool isValidMove(Pos src, Pos dest, const ChessPiece* board[][8]) override;
+		Bishop(ChessBoard::COLOUR _colour);
 };
 
 /******************** Subclass Queen *********************/
@@ -192,19 +106,9 @@ class Queen: public ChessPiece {
 	public:
 		/* Creates an instance of Queen
 		 *
-		 * @param _pos: position of the piece
 		 * @param _colour: colour of the piece
 		 */
-		Queen(Pos, ChessBoard::COLOUR);
-
-		/* Checks whether the path from source to destination is valid
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @returns: whether the path is valid
-		 */
-		bool isValidMove(Pos src, Pos dest, const ChessPiece* board[][8]) override;
+		Queen(ChessBoard::COLOUR _colour);
 };
 
 /******************** Subclass King **********************/
@@ -213,62 +117,9 @@ class King: public ChessPiece {
 	public:
 		/* Creates an instance of King
 		 *
-		 * @param _pos: position of the piece
 		 * @param _colour: colour of the piece
 		 */
-		King(Pos, ChessBoard::COLOUR);
-
-		/* Checks whether the path from source to destination is valid
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @returns: whether the path is valid
-		 */
-		bool isValidMove(Pos src, Pos dest, const ChessPiece* board[][8]) override;
-
-		/* Checks whether the path from source to destination is a valid castling move
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @param castlingState: the castling availability of ChessBoard
-		 * @returns: whether the path is a castling move
-		 */
-		bool isCastlingMove(Pos src, Pos dest, const ChessPiece* board[][8], 
-				const char* castlingState);
-
-		bool isCastling; //whether the king is making a castling move
-
-	private:
-		/* Checks whether the squares between the source and destination can be taken 
-		 * by opponent
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @returns: whether the path for castling is clear
-		 */
-		bool isPathBlocked(Pos src, Pos dest, const ChessPiece* board[][8]);
-
-		/* Checks whether the castling move is in the board's castling availability 
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @param castlingState: the castling availability of ChessBoard
-		 * @returns: whether castling is available
-		 */
-		bool checkCastlingState(Pos src, Pos dest, const ChessPiece* board[][8],
-								const char* castlingState);
-
-		/* Checks whether char c is in the char array castlingState
-		 *
-		 * @param c: char to be match
-		 * @param castlingState: the castling availability of ChessBoard
-		 * @returns: whether castlingState contains c
-		 */
-		bool contains(char c, const char* castlingState);
+		King(ChessBoard::COLOUR _colour);
 };
 
 /******************** Subclass Pawn **********************/
@@ -277,32 +128,9 @@ class Pawn: public ChessPiece {
 	public:
 		/* Creates an instance of Pawn
 		 *
-		 * @param _pos: position of the piece
 		 * @param _colour: colour of the piece
 		 */
-		Pawn(Pos, ChessBoard::COLOUR);
-
-		/* Checks whether the path from source to destination is valid
-		 *
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @returns: whether the path is valid
-		 */
-		bool isValidMove(Pos src, Pos dest, const ChessPiece* board[][8]) override;
-
-	private:
-		/* Checks whether the distance the pawn moves is valid
-		 *
-		 * @param rowStep: direction and magnitude to move along row
-		 * @param colStep: direction and magnitued to move along column
-		 * @param src: source position
-		 * @param dest: destination position
-		 * @param board: the ChessBoard
-		 * @returns: whether the distance the pawn moves is valid
-		 */
-		bool isValidDistance(int rowStep, int colStep, Pos src, Pos dest, 
-							 const ChessPiece* board[][8]);
+		Pawn(ChessBoard::COLOUR _colour);
 };
 
 #endif
@@ -0,0 +1,13 @@
+#include <iostream>
+#include "MoveList.h"
+
+std::ostream& operator << (std::ostream& output, const Move& move) {
+	//print source and destination files and ranks (row 0 is rank 8)
+	output << char('A' + (move.from() & 7)) << char('8' - (move.from() >> 3))
+		   << char('A' + (move.to() & 7)) << char('8' - (move.to() >> 3));
+	//print the promotion piece in Forsyth-Edwards Notation
+	if (move.type() == Move::PROMOTION) {
+		output << "PNBRQK"[move.promotion()];
+	}
+	return output;
+}
@@ -0,0 +1,184 @@
+/* MoveList.h - header file for the classes Move and MoveList */
+
+#ifndef MOVELIST_H
+#define MOVELIST_H
+
+#include <cstdint>
+#include <iostream>
+#include "Position.h"
+
+/********************* Class Move *********************/
+
+class Move {
+	public:
+		/* Represents the kind of a move
+		 *
+		 * @value NORMAL: a move or capture with no special rules
+		 * @value PROMOTION: a pawn reaching the last row and becoming another piece
+		 * @value EN_PASSANT: a pawn taking a pawn that has just moved two squares past it
+		 * @value CASTLING: a king moving two squares towards a rook, which jumps over it
+		 */
+		enum TYPE {NORMAL, PROMOTION, EN_PASSANT, CASTLING};
+
+		/* Creates an empty Move that does not represent any move
+		 */
+		Move() : data(0) {}
+
+		/* Creates an instance of Move
+		 *
+		 * @param from: square index of the source
+		 * @param to: square index of the destination
+		 * @param type: kind of move
+		 * @param promotion: piece a pawn becomes (KNIGHT to QUEEN), only used for PROMOTION
+		 */
+		Move(int from, int to, TYPE type = NORMAL,
+			 Position::PIECE promotion = Position::KNIGHT)
+			: data(uint16_t(from | to << 6 | (promotion - Position::KNIGHT) << 12
+							| type << 14)) {}
+
+		/* Getter for the source square
+		 *
+		 * @returns: square index of the source
+		 */
+		int from() const {
+			return data & 63;
+		}
+
+		/* Getter for the destination square
+		 *
+		 * @returns: square index of the destination
+		 */
+		int to() const {
+			return (data >> 6) & 63;
+		}
+
+		/* Getter for the kind of move
+		 *
+		 * @returns: the move's TYPE
+		 */
+		TYPE type() const {
+			return static_cast<TYPE>(data >> 14);
+		}
+
+		/* Getter for the piece a pawn promotes to
+		 *
+		 * @returns: KNIGHT, BISHOP, ROOK or QUEEN
+		 */
+		Position::PIECE promotion() const {
+			return static_cast<Position::PIECE>(((data >> 12) & 3) + Position::KNIGHT);
+		}
+
+		/* Getter for the 16 bits the move is stored in, so it can be kept in a table
+		 *
+		 * @returns: the bits of the move
+		 */
+		uint16_t raw() const {
+			return data;
+		}
+
+		/* Creates a Move from the bits of another Move
+		 *
+		 * @param bits: bits from raw()
+		 * @returns: the Move
+		 */
+		static Move fromRaw(uint16_t bits) {
+			Move move;
+			move.data = bits;
+			return move;
+		}
+
+		/* Overloads the == operator to compare if the other Move is the same
+		 *
+		 * @param other: Move to compare to
+		 * @returns: whether the two Moves are the same
+		 */
+		bool operator == (const Move& other) const {
+			return data == other.data;
+		}
+
+		/* Overloads the << operator to print a Move as source and destination in rank and
+		 * file form, followed by the promotion piece if any (e.g. E2E4 or E7E8Q)
+		 *
+		 * @param std::ostream&: output stream to write to
+		 * @param Move&: Move to print
+		 * @returns: the output stream
+		 */
+		friend std::ostream& operator << (std::ostream&, const Move&);
+
+	private:
+		//bits 0-5: source, bits 6-11: destination, bits 12-13: promotion piece,
+		//bits 14-15: type
+		uint16_t data;
+};
+
+/******************* Class MoveList *******************/
+
+class MoveList {
+	public:
+		static const int CAPACITY = 256; //more than the most legal moves in any position
+
+		/* Creates an empty MoveList
+		 */
+		MoveList() : count(0) {}
+
+		/* Adds a move to the end of the list
+		 *
+		 * @param move: the move to add
+		 */
+		void add(Move move) {
+			moves[count++] = move;
+		}
+
+		/* Removes the move at an index by moving the last move into its place
+		 *
+		 * @param index: index of the move to remove
+		 */
+		void remove(int index) {
+			moves[index] = moves[--count];
+		}
+
+		/* Empties the list
+		 */
+		void clear() {
+			count = 0;
+		}
+
+		/* Getter for the number of moves in the list
+		 *
+		 * @returns: the number of moves
+		 */
+		int size() const {
+			return count;
+		}
+
+		/* Overloads the [] operator to get the move at an index
+		 *
+		 * @param index: index of the move
+		 * @returns: the move
+		 */
+		Move operator [] (int index) const {
+			return moves[index];
+		}
+
+		/* Gets the start of the list for range-based for loops
+		 *
+		 * @returns: pointer to the first move
+		 */
+		const Move* begin() const {
+			return moves;
+		}
+
+		/* Gets the end of the list for range-based for loops
+		 *
+		 * @returns: pointer past the last move
+		 */
+		const Move* end() const {
+			return moves + count;
+		}
+
+	private:
+		Move moves[CAPACITY]; //the moves, stored in place so no heap memory is used
+		int count; //number of moves in the list
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "MoveObserver.h"
+
+using namespace std;
+
+//names of the pieces, indexed by PIECE
+static const char* const pieceNames[] = {"Pawn", "Knight", "Bishop", "Rook", "Queen", "King"};
+
+MoveObserver::~MoveObserver() {}
+
+PrintingObserver::PrintingObserver(std::ostream& _output) : output(_output) {}
+
+void PrintingObserver::moveSubmitted(const ChessBoard& board, const char* src, const char* dest,
+									 const MoveResult& result) {
+	Position::COLOUR opponent = static_cast<Position::COLOUR>(result.colour ^ Position::WHITE
+															  ^ Position::BLACK);
+	buffer.str("");
+	switch (result.status) {
+		case MoveResult::INVALID_POSITION:
+			buffer << "Invalid position inputted\n";
+			break;
+		case MoveResult::NO_PIECE:
+			buffer << "There is no piece at position " << src << "!\n";
+			break;
+		case MoveResult::WRONG_TURN:
+			buffer << "It is not " << result.colour << "'s turn to move!\n";
+			break;
+		case MoveResult::ILLEGAL_MOVE:
+			buffer << result.colour << "'s " << pieceNames[result.piece] << " cannot move to "
+				   << dest << "!\n";
+			break;
+		case MoveResult::MOVED:
+			//print the move, with any piece taken and what a pawn is promoted to
+			buffer << result.colour << "'s " << pieceNames[result.piece] << " moves from "
+				   << src << " to " << dest;
+			if (result.captured != -1) {
+				buffer << " taking " << opponent << "'s " << pieceNames[result.captured];
+			}
+			if (result.move.type() == Move::PROMOTION) {
+				buffer << " and is promoted to " << result.colour << "'s "
+					   << pieceNames[result.move.promotion()];
+			}
+			//print check, checkmate or stalemate of the player who now has the move
+			if (result.check) {
+				buffer << '\n' << opponent << " is in " << (result.checkmate ? "checkmate" : "check");
+			} else if (result.stalemate) {
+				buffer << "stalemate";
+			}
+			buffer << '\n' << board << '\n';
+			break;
+	}
+	//write and flush the whole result at once
+	output << buffer.str();
+	output.flush();
+}
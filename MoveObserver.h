@@ -0,0 +1,56 @@
+/* MoveObserver.h - header file for the classes MoveObserver and PrintingObserver */
+
+#ifndef MOVEOBSERVER_H
+#define MOVEOBSERVER_H
+
+#include <iostream>
+#include <sstream>
+#include "ChessBoard.h"
+#include "MoveResult.h"
+
+/***************** Superclass MoveObserver *****************/
+
+class MoveObserver {
+	public:
+		/* Receives the result of a move submitted to a ChessBoard, after it is made
+		 *
+		 * @param board: the ChessBoard the move was submitted to
+		 * @param src: location of the piece to move represented by rank and file
+		 * @param dest: location to move to represented by rank and file
+		 * @param result: the outcome of the move
+		 */
+		virtual void moveSubmitted(const ChessBoard& board, const char* src, const char* dest,
+								   const MoveResult& result) = 0;
+
+		/* Destructor for MoveObserver
+		 */
+		virtual ~MoveObserver();
+};
+
+/**************** Subclass PrintingObserver ****************/
+
+class PrintingObserver: public MoveObserver {
+	public:
+		/* Creates an instance of PrintingObserver
+		 *
+		 * @param _output: the output stream to print to
+		 */
+		PrintingObserver(std::ostream& _output);
+
+		/* Prints the move, any check, checkmate or stalemate and the board, or why the
+		 * move was not made, writing the text to the output stream all at once
+		 *
+		 * @param board: the ChessBoard the move was submitted to
+		 * @param src: location of the piece to move represented by rank and file
+		 * @param dest: location to move to represented by rank and file
+		 * @param result: the outcome of the move
+		 */
+		void moveSubmitted(const ChessBoard& board, const char* src, const char* dest,
+						   const MoveResult& result) override;
+
+	private:
+		std::ostream& output; //the output stream to print to
+		std::ostringstream buffer; //text of the result being printed
+};
+
+#endif
@@ -0,0 +1,35 @@
+/* MoveResult.h - header file for the struct MoveResult */
+
+#ifndef MOVERESULT_H
+#define MOVERESULT_H
+
+#include <cstdint>
+#include "MoveList.h"
+#include "Position.h"
+
+/******************* Struct MoveResult *******************/
+
+/* The outcome of a move submitted to a ChessBoard, filled without printing anything
+ */
+struct MoveResult {
+	/* Represents whether a submitted move was made, or why not
+	 *
+	 * @value MOVED: the move was made
+	 * @value INVALID_POSITION: the source or destination is not a square
+	 * @value NO_PIECE: there is no piece on the source square
+	 * @value WRONG_TURN: the piece belongs to the player who does not have the move
+	 * @value ILLEGAL_MOVE: the piece cannot move to the destination
+	 */
+	enum STATUS {MOVED, INVALID_POSITION, NO_PIECE, WRONG_TURN, ILLEGAL_MOVE};
+
+	STATUS status; //whether the move was made
+	Move move; //the move made, if it was made
+	Position::COLOUR colour; //colour of the piece on the source square, if there is one
+	int8_t piece; //type of the piece on the source square (a Position::PIECE), or -1
+	int8_t captured; //type of the piece taken (a Position::PIECE), or -1
+	bool check; //whether the player who now has the move is in check (or checkmate)
+	bool checkmate; //whether the player who now has the move is in checkmate
+	bool stalemate; //whether the player who now has the move is in stalemate
+};
+
+#endif
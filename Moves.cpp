@@ -1,165 +1,212 @@
-#include <iostream>
 #include "Moves.h"
 
-using namespace std;
+/************* Compile time attack table generation *************/
 
-const ChessPiece* isDiagonal(Pos src, Pos dest, const ChessPiece* board[][8]) {
-	//check destination is on a diagonal path
-	if (abs(dest.row - src.row) != abs(dest.col - src.col)) { 
-		return board[src.row][src.col];	
-	}
-	//determine the direction of the diagonal
-	int rowStep = (dest.row > src.row) ? 1 : -1;
-	int colStep = (dest.col > src.col) ? 1 : -1;
-
-	//traverse the diagonal path from source to destination
-	for (int row = src.row + rowStep, col = src.col + colStep;
-			row != dest.row || col != dest.col;
-			row += rowStep, col += colStep) {
-		//check if the path is clear else return piece in path
-		if (board[row][col]) {
-			return board[row][col];
-		}
-	}
-	return NULL;
+/* Gets the squares a pawn attacks diagonally
+ *
+ * @param colour: colour of the pawn
+ * @param b: Bitboard of the pawn's square
+ * @returns: Bitboard of attacked squares
+ */
+static constexpr Bitboard makePawnAttacks(int colour, Bitboard b) {
+	//white pawns attack towards row 0, black pawns towards row 7
+	return (colour == Position::WHITE) 
+		 ? ((b & ~FILE_A_BB) >> 9) | ((b & ~FILE_H_BB) >> 7)
+		 : ((b & ~FILE_A_BB) << 7) | ((b & ~FILE_H_BB) << 9);
 }
 
-const ChessPiece* isVertical(Pos src, Pos dest, const ChessPiece* board[][8]) {
-	//check if destination is in same column as source
-	if (src.col != dest.col) {
-		return board[src.row][src.col];
-	}
-	//determine the direction of the vertical path
-	int rowStep = (dest.row > src.row) ? 1 : -1;
-
-	//traverse the vertical path from source to destination
-	for (int row = src.row + rowStep; row != dest.row; row += rowStep) {
-		//check if the path is clear else return piece in path
-		if (board[row][src.col]) {
-			return board[row][src.col];
-		}
-	}
-	return NULL;
+/* Gets the squares a pawn moves forward to on an empty board
+ *
+ * @param colour: colour of the pawn
+ * @param b: Bitboard of the pawn's square
+ * @returns: Bitboard of destination squares
+ */
+static constexpr Bitboard makePawnPushes(int colour, Bitboard b) {
+	//pawns on their start row (row 6 for white, row 1 for black) can also move two steps
+	return (colour == Position::WHITE) 
+		 ? (b >> 8) | ((b & (ROW_0_BB << 48)) >> 16)
+		 : (b << 8) | ((b & (ROW_0_BB << 8)) << 16);
 }
 
-const ChessPiece* isHorizontal(Pos src, Pos dest, const ChessPiece* board[][8]) {
-	//check if destination is in same row as source
-	if (src.row != dest.row) {
-		return board[src.row][src.col];
-	}
-	//determine the direction of the horizontal path
-	int colStep = (dest.col > src.col) ? 1 : -1;
-
-	//traverse the horizontal path from source to destination
-	for (int col = src.col + colStep; col != dest.col; col += colStep) {
-		//check if the path is clear else return piece in path
-		if (board[src.row][col]) {
-			return board[src.row][col];
-		}
-	}
-	return NULL;
+/* Gets the squares a knight attacks
+ *
+ * @param b: Bitboard of the knight's square
+ * @returns: Bitboard of attacked squares
+ */
+static constexpr Bitboard makeKnightAttacks(Bitboard b) {
+	//squares one and two columns away, masked so moves cannot wrap around the board
+	Bitboard l1 = (b >> 1) & ~FILE_H_BB;
+	Bitboard l2 = (b >> 2) & ~(FILE_H_BB | FILE_H_BB >> 1);
+	Bitboard r1 = (b << 1) & ~FILE_A_BB;
+	Bitboard r2 = (b << 2) & ~(FILE_A_BB | FILE_A_BB << 1);
+	//shift one column steps by two rows and two column steps by one row
+	Bitboard h1 = l1 | r1;
+	Bitboard h2 = l2 | r2;
+	return (h1 << 16) | (h1 >> 16) | (h2 << 8) | (h2 >> 8);
 }
 
-bool isL(Pos src, Pos dest) {
-	if (!(abs(src.row - dest.row) == 2 && abs(src.col - dest.col) == 1)
-			&& !(abs(src.row - dest.row) == 1 && abs(src.col - dest.col) == 2)) {
-		return false;
-	}
-	return true;
+/* Gets the squares a king attacks
+ *
+ * @param b: Bitboard of the king's square
+ * @returns: Bitboard of attacked squares
+ */
+static constexpr Bitboard makeKingAttacks(Bitboard b) {
+	//spread the king sideways, then spread that row up and down
+	Bitboard row = b | ((b >> 1) & ~FILE_H_BB) | ((b << 1) & ~FILE_A_BB);
+	return (row | (row >> 8) | (row << 8)) & ~b;
 }
 
-const ChessPiece* isDiagonalCheck(Pos src, Pos dest, const ChessPiece* board[][8], 
-		ChessBoard::COLOUR sideToMove, char except) {
-	//if source equals destination, it is not a valid move
-	if (src == dest) {
-		return NULL;
+/* Builds every table in AttackTables
+ *
+ * @returns: the filled tables
+ */
+static constexpr AttackTables makeAttackTables() {
+	AttackTables tables{};
+	//the eight directions, ordered so that direction 7 - d is opposite to direction d
+	const int directions[8][2] = {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, 
+								  {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+	for (int square = 0; square < 64; square++) {
+		Bitboard b = squareBB(square);
+		for (int colour = Position::BLACK; colour <= Position::WHITE; colour++) {
+			tables.pawnAttacks[colour][square] = makePawnAttacks(colour, b);
+			tables.pawnPushes[colour][square] = makePawnPushes(colour, b);
+		}
+		tables.knightAttacks[square] = makeKnightAttacks(b);
+		tables.kingAttacks[square] = makeKingAttacks(b);
+		//get the ray from the square to the edge of the board in each direction
+		Bitboard rays[8] = {};
+		for (int d = 0; d < 8; d++) {
+			int row = (square >> 3) + directions[d][0];
+			int col = (square & 7) + directions[d][1];
+			for (; 0 <= row && row < 8 && 0 <= col && col < 8; 
+					row += directions[d][0], col += directions[d][1]) {
+				rays[d] |= squareBB(row * 8 + col);
+			}
+		}
+		//walk each ray again, recording the path so far and the whole line
+		for (int d = 0; d < 8; d++) {
+			Bitboard path = 0;
+			int row = (square >> 3) + directions[d][0];
+			int col = (square & 7) + directions[d][1];
+			for (; 0 <= row && row < 8 && 0 <= col && col < 8; 
+					row += directions[d][0], col += directions[d][1]) {
+				tables.between[square][row * 8 + col] = path;
+				tables.line[square][row * 8 + col] = rays[d] | rays[7 - d] | b;
+				path |= squareBB(row * 8 + col);
+			}
+		}
 	}
-	//get any piece that is between source and destination
-	const ChessPiece* takingPiece = isDiagonal(src, dest, board);
-	//check if that piece can take the piece at the source location
-	return canCheck(takingPiece, src, dest, board, sideToMove, except);
+	return tables;
 }
 
-const ChessPiece* isVerticalCheck(Pos src, Pos dest, const ChessPiece* board[][8], 
-		ChessBoard::COLOUR sideToMove, char except) {
-	//if source equals destination, it is not a valid move
-	if (src == dest) {
-		return NULL;
-	}
-	//get any piece that is between source and destination
-	const ChessPiece* takingPiece = isVertical(src, dest, board);
-	//check if that piece can take the piece at the source location
-	return canCheck(takingPiece, src, dest, board, sideToMove, except);
-}
+constexpr AttackTables attackTables = makeAttackTables();
 
-const ChessPiece* isHorizontalCheck(Pos src, Pos dest, const ChessPiece* board[][8], 
-		ChessBoard::COLOUR sideToMove, char except) {
-	//if source equals destination, it is not a valid move
-	if (src == dest) {
-		return NULL;
-	}
-	//get any piece that is between source and destination
-	const ChessPiece* takingPiece = isHorizontal(src, dest, board);
-	//check if that piece can take the piece at the source location
-	return canCheck(takingPiece, src, dest, board, sideToMove, except);
-}
+/************** Sliding attack table initialisation **************/
 
-const ChessPiece* isLCheck(Pos pos, const ChessPiece* board[][8], 
-						   ChessBoard::COLOUR sideToMove) {
-	//setup an array of possible locations relative to pos
-	const int LMoves[][2] = {
-		{-2, -1}, {-2, 1},
-		{-1, -2}, {-1, 2},
-		{1, -2}, {1, 2},
-		{2, -1}, {2, 1}
-	};
-	//for each possible L position
-	for (int i = 0; i < 8; i++) {
-		int row = pos.row + LMoves[i][0];
-		int col = pos.col + LMoves[i][1];
-		//if it is on the board
-		if ((0 <= row && row < 8) && (0 <= col && col < 8)) {
-			const ChessPiece* takingPiece = board[row][col];
-			//ensure that takingPiece is a knight and can take the piece at pos 
-			if (takingPiece && (takingPiece->getSymbol() == 'n' 
-						 	||  takingPiece->getSymbol() == 'N')) {
-				if (canCheck(takingPiece, pos, Pos(-1, -1), board, sideToMove)) {
-					return takingPiece;
-				}
+/* Walks the rays from a square on a Bitboard, stopping at the first occupied square
+ *
+ * @param square: square index of the sliding piece
+ * @param occupied: Bitboard of all occupied squares
+ * @param directions: row and column steps of the rays
+ * @returns: Bitboard of squares along the rays
+ */
+static Bitboard slidingAttacks(int square, Bitboard occupied, const int directions[][2]) {
+	Bitboard attacks = 0;
+	//for each of the four rays
+	for (int i = 0; i < 4; i++) {
+		int row = (square >> 3) + directions[i][0];
+		int col = (square & 7) + directions[i][1];
+		//add squares until the edge of the board or a blocker is reached
+		while (0 <= row && row < 8 && 0 <= col && col < 8) {
+			attacks |= squareBB(row * 8 + col);
+			if (occupied & squareBB(row * 8 + col)) {
+				break;
 			}
+			row += directions[i][0];
+			col += directions[i][1];
 		}
 	}
-	//if there are no knights in L positions around pos, return NULL
-	return NULL;
+	return attacks;
 }
 
-const ChessPiece* canCheck(const ChessPiece* takingPiece, Pos src, Pos dest, 
-		const ChessPiece* board[][8], ChessBoard::COLOUR sideToMove, char except) {
-	//if takingPiece is a piece that should not be moved, return NULL
-	if (takingPiece && (takingPiece->getSymbol() == except 
-					||  takingPiece->getSymbol() == except + 32)) {
-		return NULL;
-	}
-	//if there are no pieces up to the edge and no pieces at the edge, return NULL
-	if (!takingPiece && !board[dest.row][dest.col]) {
-		return NULL;
-	} 
-	//else assume that the piece at the edge is the takingPiece
-	else if (!takingPiece) {
-		takingPiece = board[dest.row][dest.col]; 
-	}
-	//if the piece at src is taken by the opponent takingPiece or if takingPiece is just 
-	//moving to src location
-	if ((board[src.row][src.col] 
-			&& takingPiece->getColour() != board[src.row][src.col]->getColour())
-			|| (board[src.row][src.col] == NULL && takingPiece->getColour() == sideToMove)) {
-		//if the move is valid
-		if (((ChessPiece*)takingPiece)->isValidMove(takingPiece->getPos(), src, board)) { 
-			//takingPiece can take the piece at src, return the taking Piece
-			return takingPiece;
-		}
+Magic bishopMagics[64];
+Magic rookMagics[64];
+
+static Bitboard bishopTable[0x1480]; //attack sets of all bishop magics
+static Bitboard rookTable[0x19000]; //attack sets of all rook magics
+
+//magic multipliers for each square, found offline by a random search for sparse numbers
+//that hash every blocker subset of the square without destructive collisions
+static const Bitboard bishopMagicNumbers[64] = {
+	0x0040040410820010ULL, 0x4008024842002040ULL, 0x0310810645000000ULL, 0x4250890200004000ULL,
+	0x8021104048080401ULL, 0x1001042084090304ULL, 0x000210C208400A00ULL, 0x20001104012008E0ULL,
+	0x0000080830008208ULL, 0x002230824A040020ULL, 0x0000100400982000ULL, 0x0002022082080509ULL,
+	0x010001104104C110ULL, 0x0499009010480000ULL, 0x0002010801504880ULL, 0x0400810888010820ULL,
+	0x00204A4684140800ULL, 0x0088411011480482ULL, 0x0982000408020008ULL, 0x02040202C4008000ULL,
+	0x0001002820080801ULL, 0x0420C10600462010ULL, 0x0280408209500800ULL, 0x0201480109180101ULL,
+	0xA008E0000820E100ULL, 0x0410020084244408ULL, 0x0110480884102402ULL, 0x0010040000440088ULL,
+	0x0800848004002000ULL, 0x0408820403004200ULL, 0x00040400A8422200ULL, 0x0000410020411800ULL,
+	0x040C200800A53002ULL, 0x0804100231040408ULL, 0x4021080242280180ULL, 0x4000A02020080080ULL,
+	0x08812104008A0020ULL, 0x00201108400A0804ULL, 0x8504042082405800ULL, 0x0024008020008C00ULL,
+	0x4006491040400820ULL, 0x0004980108149108ULL, 0x8012084050000805ULL, 0x2006084200824810ULL,
+	0x0470880104004042ULL, 0x1040280800200040ULL, 0x0811501210404480ULL, 0x400208A401002082ULL,
+	0x0C47040104410A04ULL, 0x0001040211840000ULL, 0x00040B0041108002ULL, 0x2000000084041804ULL,
+	0x0002202020410008ULL, 0x0282405002108000ULL, 0x4098105004C50200ULL, 0x120802180A002014ULL,
+	0x0001210042602003ULL, 0x1004004420841020ULL, 0x4100028024841010ULL, 0x0144800210208801ULL,
+	0x6000020004105400ULL, 0x0902084104080088ULL, 0x2228886008008120ULL, 0x0002089010808500ULL
+};
+
+static const Bitboard rookMagicNumbers[64] = {
+	0x0A80008010400020ULL, 0x40C0004020001008ULL, 0x2080100020000880ULL, 0x0900100088210004ULL,
+	0x08802C0048008002ULL, 0x0800844010020820ULL, 0x2080808002000100ULL, 0x4200040048802201ULL,
+	0x0018800028400480ULL, 0x2121002081004002ULL, 0x0041805000200082ULL, 0x9085002100100008ULL,
+	0x6841000501100800ULL, 0x0860800200800401ULL, 0x0100808002000100ULL, 0x0202001041008204ULL,
+	0x0040008000402084ULL, 0x1010210040010884ULL, 0x0204410010200106ULL, 0x0050008014080080ULL,
+	0x4000050010880100ULL, 0x4012008004008002ULL, 0xA000840002080110ULL, 0x12042200008419C3ULL,
+	0x009264808000400AULL, 0x8070500040002000ULL, 0x9093001100200140ULL, 0x4080420200201008ULL,
+	0x0008008880040080ULL, 0xC020100801400420ULL, 0x0101080C000A0110ULL, 0x1000104200240081ULL,
+	0x8480002010400040ULL, 0x104040008080200CULL, 0x1200821002802001ULL, 0x8800800802801002ULL,
+	0x2008002004040040ULL, 0x0290204088010410ULL, 0x04000110040002D8ULL, 0x8841042082000041ULL,
+	0x0060400080088020ULL, 0x0240008020008040ULL, 0x0002402003090010ULL, 0x0001000810010020ULL,
+	0x0C02000820120004ULL, 0x0022000410020008ULL, 0x0000020004010100ULL, 0x010000A400420001ULL,
+	0x0941008042002A00ULL, 0x2000834008200880ULL, 0x0000108040220200ULL, 0x0000100080080080ULL,
+	0x8000802041001002ULL, 0x0202001008142600ULL, 0x0901000E00040500ULL, 0x00010008B2004100ULL,
+	0x1042052100418216ULL, 0x0106018010E24902ULL, 0x1000412813006001ULL, 0x1000040900201001ULL,
+	0x0421000410020801ULL, 0x8802004490080102ULL, 0x0084183043810604ULL, 0x00001402810040A2ULL
+};
+
+/* Fills the magic entries and attack table of a sliding piece
+ *
+ * @param magics: magic entries to fill, indexed by square
+ * @param table: attack table shared by all squares
+ * @param directions: row and column steps of the piece's rays
+ * @param magicNumbers: magic multiplier of each square
+ */
+static void initMagics(Magic magics[], Bitboard table[], const int directions[][2],
+					   const Bitboard magicNumbers[]) {
+	Bitboard* next = table;
+	for (int square = 0; square < 64; square++) {
+		Magic& m = magics[square];
+		//squares on the edge of the board never block anything beyond them
+		Bitboard edges = ((ROW_0_BB | ROW_7_BB) & ~rowBB(square))
+					   | ((FILE_A_BB | FILE_H_BB) & ~colBB(square));
+		m.mask = slidingAttacks(square, 0, directions) & ~edges;
+		m.magic = magicNumbers[square];
+		m.shift = 64 - popCount(m.mask);
+		m.attacks = next;
+		//walk every subset of the mask and store its attack set
+		Bitboard subset = 0;
+		do {
+			m.attacks[m.index(subset)] = slidingAttacks(square, subset, directions);
+			subset = (subset - m.mask) & m.mask;
+		} while (subset);
+		next += 1ULL << popCount(m.mask);
 	}
-	//if takingPiece cannot move to src location, return NULL
-	return NULL;
 }
 
+void initAttacks() {
+	const int bishopDirections[][2] = {{-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+	const int rookDirections[][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+	initMagics(bishopMagics, bishopTable, bishopDirections, bishopMagicNumbers);
+	initMagics(rookMagics, rookTable, rookDirections, rookMagicNumbers);
+}
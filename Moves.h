@@ -3,112 +3,137 @@
 #ifndef MOVES_H
 #define MOVES_H
 
-#include "ChessBoard.h"
-#include "ChessPiece.h"
-#include "Pos.h"
+#ifdef USE_PEXT
+#include <immintrin.h>
+#endif
+#include "Bitboard.h"
+#include "Position.h"
 
-/***************** Move functions *****************/ 
+/**************** Attack functions ****************/
 
-/* Checks whether there is a ChessPiece on the diagonal path between source and destination
- * (checks up to, but not including, the destination)
- *
- * @param src: source location
- * @param dest: destination location
- * @param board: the ChessBoard
- * @returns: the ChessPiece in the path or NULL
+/* Magic bitboard entry for one square of a sliding piece. The relevant blockers of the
+ * square are hashed to an index into a table of precomputed attack sets, using PEXT when
+ * built with USE_PEXT (BMI2) and a multiply and shift otherwise.
  */
-const ChessPiece* isDiagonal(Pos src, Pos dest, const ChessPiece* board[][8]);
+struct Magic {
+	Bitboard mask; //squares whose occupancy affects the attacks (board edges excluded)
+	Bitboard magic; //multiplier mapping each subset of mask to a unique index
+	Bitboard* attacks; //attack sets for this square, indexed by index()
+	unsigned shift; //64 minus the number of squares in mask
+
+	/* Hashes the blockers on the board to an index into attacks
+	 *
+	 * @param occupied: Bitboard of all occupied squares
+	 * @returns: index of the attack set
+	 */
+	unsigned index(Bitboard occupied) const {
+#ifdef USE_PEXT
+		return unsigned(_pext_u64(occupied, mask));
+#else
+		return unsigned(((occupied & mask) * magic) >> shift);
+#endif
+	}
+};
+
+extern Magic bishopMagics[64]; //magic entries for bishops, indexed by square
+extern Magic rookMagics[64]; //magic entries for rooks, indexed by square
 
-/* Checks whether there is a ChessPiece on the vertical path between source and destination
- * (checks up to, but not including, the destination)
+/* Fills the sliding attack tables, must be called once before any attacks are looked up
+ */
+void initAttacks();
+
+/* Attack and path tables indexed by square, generated at compile time
+ */
+struct AttackTables {
+	Bitboard pawnAttacks[2][64]; //squares a pawn of each colour attacks diagonally
+	Bitboard pawnPushes[2][64]; //squares a pawn of each colour moves forward to
+	Bitboard knightAttacks[64]; //squares a knight attacks
+	Bitboard kingAttacks[64]; //squares a king attacks
+	Bitboard between[64][64]; //squares strictly between two aligned squares, else empty
+	Bitboard line[64][64]; //squares on the whole line through two aligned squares, else empty
+};
+
+extern const AttackTables attackTables; //the tables, defined constexpr in Moves.cpp
+
+/* Gets the squares a pawn attacks diagonally
  *
- * @param src: source location
- * @param dest: destination location
- * @param board: the ChessBoard
- * @returns: the ChessPiece in the path or NULL
+ * @param colour: colour of the pawn
+ * @param square: square index of the pawn
+ * @returns: Bitboard of attacked squares
  */
-const ChessPiece* isVertical(Pos src, Pos dest, const ChessPiece* board[][8]);
+inline Bitboard pawnAttacks(Position::COLOUR colour, int square) {
+	return attackTables.pawnAttacks[colour][square];
+}
 
-/* Checks whether there is a ChessPiece on the horizontal path between source and destination
- * (checks up to, but not including, the destination)
+/* Gets the squares a pawn moves forward to on an empty board (one step, or one and two
+ * steps from its start row)
  *
- * @param src: source location
- * @param dest: destination location
- * @param board: the ChessBoard
- * @returns: the ChessPiece in the path or NULL
+ * @param colour: colour of the pawn
+ * @param square: square index of the pawn
+ * @returns: Bitboard of destination squares
  */
-const ChessPiece* isHorizontal(Pos src, Pos dest, const ChessPiece* board[][8]);
+inline Bitboard pawnPushes(Position::COLOUR colour, int square) {
+	return attackTables.pawnPushes[colour][square];
+}
 
-/* Checks whether the path between source and destination is an L shape (for knight moves)
+/* Gets the squares a knight attacks
  *
- * @param src: source location
- * @param dest: destination location
- * @returns: whether the path is in an L shape
+ * @param square: square index of the knight
+ * @returns: Bitboard of attacked squares
  */
-bool isL(Pos src, Pos dest);
+inline Bitboard knightAttacks(int square) {
+	return attackTables.knightAttacks[square];
+}
 
-/* Checks if there is a piece on the diagonal path between source and destination, and 
- * whether that piece can capture the piece at the source
+/* Gets the squares a king attacks
  *
- * @param src: source location
- * @param dest: destination location
- * @param board: the ChessBoard
- * @param sideToMove: which player has the move
- * @param except: FEN representation of the piece that is not allowed to move
- * @returns: ChessPiece that can take the piece at src diagonally, otherwise NULL
+ * @param square: square index of the king
+ * @returns: Bitboard of attacked squares
  */
-const ChessPiece* isDiagonalCheck(Pos src, Pos dest, const ChessPiece* board[][8], 
-								  ChessBoard::COLOUR sideToMove, char except);
+inline Bitboard kingAttacks(int square) {
+	return attackTables.kingAttacks[square];
+}
 
-/* Checks if there is a piece on the vertical path between source and destination, and 
- * whether that piece can capture the piece at the source
+/* Gets the squares strictly between two squares on the same row, column or diagonal
  *
- * @param src: source location
- * @param dest: destination location
- * @param board: the ChessBoard
- * @param sideToMove: which player has the move
- * @param except: FEN representation of the piece that is not allowed to move
- * @returns: ChessPiece that can take the piece at src vertically, otherwise NULL
+ * @param from: square index at one end
+ * @param to: square index at the other end
+ * @returns: Bitboard of the squares between, or empty if the squares are not aligned
  */
-const ChessPiece* isVerticalCheck(Pos src, Pos dest, const ChessPiece* board[][8], 
-								  ChessBoard::COLOUR sideToMove, char except);
+inline Bitboard between(int from, int to) {
+	return attackTables.between[from][to];
+}
 
-/* Checks if there is a piece on the horizontal path between source and destination, and
- * whether that piece can capture the piece at the source
+/* Gets the whole row, column or diagonal through two squares, from edge to edge
  *
- * @param src: source location
- * @param dest: destination location
- * @param board: the ChessBoard
- * @param sideToMove: which player has the move
- * @param except: FEN representation of the piece that is not allowed to move
- * @returns: ChessPiece that can take the piece at src horizontally, otherwise NULL
+ * @param from: square index on the line
+ * @param to: another square index on the line
+ * @returns: Bitboard of the line including both squares, or empty if they are not aligned
  */
-const ChessPiece* isHorizontalCheck(Pos src, Pos dest, const ChessPiece* board[][8], 
-								    ChessBoard::COLOUR sideToMove, char except);
+inline Bitboard line(int from, int to) {
+	return attackTables.line[from][to];
+}
 
-/* Checks whether there are opponent knights around pos that can capture the piece at pos
+/* Gets the squares a bishop attacks, up to and including the first blocker on each diagonal
  *
- * @param pos: source location
- * @param board: the ChessBoard
- * @param sideToMove: which player has the move
- * @returns: ChessPiece that can take the piece at pos, otherwise NULL
+ * @param square: square index of the bishop
+ * @param occupied: Bitboard of all occupied squares
+ * @returns: Bitboard of attacked squares
  */
-const ChessPiece* isLCheck(Pos pos, const ChessPiece* board[][8], 
-						   ChessBoard::COLOUR sideToMove);
+inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+	const Magic& m = bishopMagics[square];
+	return m.attacks[m.index(occupied)];
+}
 
-/* Checks whether piece at the source can be taken by takingPiece or destination piece at
- * the edge of the board
+/* Gets the squares a rook attacks, up to and including the first blocker on each line
  *
- * @param takingPiece: piece that has a direct path to the source piece
- * @param src: source location
- * @param dest: destination location
- * @param board: the ChessBoard
- * @param sideToMove: which player has the move
- * @param except: FEN representation of the piece that is not allowed to move
- * @returns: ChessPiece that can take the piece at src, otherwise NULL
+ * @param square: square index of the rook
+ * @param occupied: Bitboard of all occupied squares
+ * @returns: Bitboard of attacked squares
  */
-const ChessPiece* canCheck(const ChessPiece* takingPiece, Pos src, Pos dest,
-		const ChessPiece* board[][8], ChessBoard::COLOUR sideToMove, char except = '-');
+inline Bitboard rookAttacks(int square, Bitboard occupied) {
+	const Magic& m = rookMagics[square];
+	return m.attacks[m.index(occupied)];
+}
 
 #endif
-
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <type_traits>
+#include "PackedPosition.h"
+
+using namespace std;
+
+static_assert(std::is_trivially_copyable<PackedPosition>::value,
+			  "PackedPosition must be trivially copyable");
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition must be 32 bytes with no padding");
+
+/* Reads a little-endian number from bytes
+ *
+ * @param bytes: the bytes of the number, least significant first
+ * @param count: number of bytes
+ * @returns: the number
+ */
+static uint64_t readLittleEndian(const uint8_t* bytes, int count) {
+	uint64_t value = 0;
+	for (int index = count - 1; index >= 0; index--) {
+		value = (value << 8) | bytes[index];
+	}
+	return value;
+}
+
+/* Writes a number as little-endian bytes
+ *
+ * @param value: the number
+ * @param bytes: set to the bytes of the number, least significant first
+ * @param count: number of bytes
+ */
+static void writeLittleEndian(uint64_t value, uint8_t* bytes, int count) {
+	for (int index = 0; index < count; index++) {
+		bytes[index] = uint8_t(value >> (8 * index));
+	}
+}
+
+Bitboard PackedPosition::getOccupancy() const {
+	return readLittleEndian(occupancy, 8);
+}
+
+void PackedPosition::setOccupancy(Bitboard squares) {
+	writeLittleEndian(squares, occupancy, 8);
+}
+
+uint16_t PackedPosition::getHalfmoveClock() const {
+	return uint16_t(readLittleEndian(halfmoveClock, 2));
+}
+
+void PackedPosition::setHalfmoveClock(uint16_t halfmoves) {
+	writeLittleEndian(halfmoves, halfmoveClock, 2);
+}
+
+uint32_t PackedPosition::getFullmoveNumber() const {
+	return uint32_t(readLittleEndian(fullmoveNumber, 4));
+}
+
+void PackedPosition::setFullmoveNumber(uint32_t fullmoves) {
+	writeLittleEndian(fullmoves, fullmoveNumber, 4);
+}
+
+/******************* PackedWriter *******************/
+
+PackedWriter::PackedWriter(const char* path)
+	: file(path, ios::binary | ios::out | ios::trunc) {}
+
+bool PackedWriter::good() const {
+	return file.good();
+}
+
+bool PackedWriter::write(const PackedPosition* records, size_t count) {
+	//the records are bytes with no padding, so they are written as they are in memory
+	file.write(reinterpret_cast<const char*>(records), count * sizeof(PackedPosition));
+	return file.good();
+}
+
+void PackedWriter::flush() {
+	file.flush();
+}
+
+/******************* PackedReader *******************/
+
+PackedReader::PackedReader(const char* path)
+	: file(path, ios::binary | ios::in), recordCount(0), trailingBytes(0) {
+	//work out the number of records from the length of the file, which a write cut off
+	//part way through a record leaves with bytes over
+	if (file.seekg(0, ios::end)) {
+		uint64_t bytes = uint64_t(file.tellg());
+		recordCount = bytes / sizeof(PackedPosition);
+		trailingBytes = bytes % sizeof(PackedPosition);
+		file.seekg(0, ios::beg);
+	}
+}
+
+bool PackedReader::good() const {
+	return file.is_open() && trailingBytes == 0;
+}
+
+uint64_t PackedReader::size() const {
+	return recordCount;
+}
+
+size_t PackedReader::read(PackedPosition* records, size_t count) {
+	//read no further than the last whole record, so the reader is never left part way
+	//through one
+	streamoff offset = file.tellg();
+	if (offset < 0) {
+		return 0;
+	}
+	count = size_t(min<uint64_t>(count, recordCount - uint64_t(offset) / sizeof(PackedPosition)));
+	file.read(reinterpret_cast<char*>(records), count * sizeof(PackedPosition));
+	size_t bytes = size_t(file.gcount());
+	//a failed read sets the error flags, which must be cleared before the next readAt
+	file.clear();
+	return bytes / sizeof(PackedPosition);
+}
+
+bool PackedReader::readAt(uint64_t index, PackedPosition& record) {
+	if (index >= recordCount) {
+		return false;
+	}
+	file.seekg(streamoff(index * sizeof(PackedPosition)), ios::beg);
+	return read(&record) == 1;
+}
@@ -0,0 +1,156 @@
+/* PackedPosition.h - header file for the struct PackedPosition and the classes
+ * PackedWriter and PackedReader */
+
+#ifndef PACKEDPOSITION_H
+#define PACKEDPOSITION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include "Bitboard.h"
+
+/******************* Struct PackedPosition *******************/
+
+/* A position and its state packed into 32 bytes, filled by ChessBoard::toPacked and
+ * loaded by ChessBoard::loadPacked
+ *
+ * Every field is a byte or a little-endian array of bytes, so a record has no padding
+ * and the same layout on every machine. A file of records is just the records one
+ * after another, so it can be read by index or mapped into memory as an array
+ * (PackedPosition() has every byte zero)
+ */
+struct PackedPosition {
+	static const int MAX_PIECES = 32; //pieces a record can hold
+	static const uint8_t CASTLING_MASK = 15; //bits of flags holding the castling rights
+	static const uint8_t WHITE_TO_MOVE = 16; //bit of flags set when White has the move
+	static const uint8_t NO_SQUARE = 255; //epSquare when there is no en passant square
+
+	uint8_t occupancy[8]; //Bitboard of the occupied squares, little-endian
+	uint8_t pieces[16]; //code of the piece on each occupied square in square order, two
+						//to a byte with the first in the low nibble (see ChessBoard)
+	uint8_t flags; //castling rights (Position::CASTLING_RIGHT flags) and WHITE_TO_MOVE
+	uint8_t epSquare; //en passant square, or NO_SQUARE
+	uint8_t halfmoveClock[2]; //moves since the last capture or pawn move, little-endian
+	uint8_t fullmoveNumber[4]; //number of the move, starting at 1, little-endian
+
+	/* Getter for occupancy
+	 *
+	 * @returns: the occupied squares
+	 */
+	Bitboard getOccupancy() const;
+
+	/* Setter for occupancy
+	 *
+	 * @param squares: the occupied squares
+	 */
+	void setOccupancy(Bitboard squares);
+
+	/* Getter for halfmoveClock
+	 *
+	 * @returns: the halfmove clock
+	 */
+	uint16_t getHalfmoveClock() const;
+
+	/* Setter for halfmoveClock
+	 *
+	 * @param halfmoves: the halfmove clock
+	 */
+	void setHalfmoveClock(uint16_t halfmoves);
+
+	/* Getter for fullmoveNumber
+	 *
+	 * @returns: the fullmove number
+	 */
+	uint32_t getFullmoveNumber() const;
+
+	/* Setter for fullmoveNumber
+	 *
+	 * @param fullmoves: the fullmove number
+	 */
+	void setFullmoveNumber(uint32_t fullmoves);
+};
+
+/******************* Class PackedWriter *******************/
+
+/* Writes PackedPositions to the end of a file as they are given
+ */
+class PackedWriter {
+	public:
+		/* Creates an instance of PackedWriter, opening a file and emptying it
+		 *
+		 * @param path: path of the file to write
+		 */
+		PackedWriter(const char* path);
+
+		/* Getter for whether the file is open and every write has succeeded
+		 *
+		 * @returns: whether the file can be written
+		 */
+		bool good() const;
+
+		/* Writes records after those already written
+		 *
+		 * @param records: the records to write
+		 * @param count: number of records
+		 * @returns: whether they were written
+		 */
+		bool write(const PackedPosition* records, size_t count = 1);
+
+		/* Writes any buffered records to the file
+		 */
+		void flush();
+
+	private:
+		std::ofstream file; //the file written to
+};
+
+/******************* Class PackedReader *******************/
+
+/* Reads PackedPositions from a file, in order or by index
+ */
+class PackedReader {
+	public:
+		/* Creates an instance of PackedReader, opening a file
+		 *
+		 * @param path: path of the file to read
+		 */
+		PackedReader(const char* path);
+
+		/* Getter for whether the file is open and holds only whole records. A file that
+		 * ends part way through a record is not good, though the whole records before
+		 * it can still be read
+		 *
+		 * @returns: whether the file can be read and is not truncated
+		 */
+		bool good() const;
+
+		/* Getter for the number of whole records in the file
+		 *
+		 * @returns: the number of records
+		 */
+		uint64_t size() const;
+
+		/* Reads the records after those already read
+		 *
+		 * @param records: set to the records read
+		 * @param count: most records to read
+		 * @returns: number of records read, which is less than count at the end of the
+		 *			 file, where a truncated last record is never read
+		 */
+		size_t read(PackedPosition* records, size_t count = 1);
+
+		/* Reads a record by its index, then carries on reading in order from after it
+		 *
+		 * @param index: index of the record in the file
+		 * @param record: set to the record
+		 * @returns: whether the index is in the file and the record was read
+		 */
+		bool readAt(uint64_t index, PackedPosition& record);
+
+	private:
+		std::ifstream file; //the file read from
+		uint64_t recordCount; //number of whole records in the file
+		uint64_t trailingBytes; //bytes after the last whole record, 0 unless truncated
+};
+
+#endif
@@ -0,0 +1,340 @@
+/* Perft.cpp - counts the leaf nodes of the move tree to a depth, to check the move
+ * generator against known counts and time it
+ *
+ * ./perft                  runs the reference positions and checks their counts
+ * ./perft <depth> [FEN]    prints the count under each legal move ("divide") of the
+ *                          position (the start position by default)
+ *
+ * Either can be given -j <threads> to share the first two plies out between threads,
+ * and -H <megabytes> to remember the counts of subtrees reached more than once, and
+ * when built with STATS=1, -s <text|json> to print the hot path counters at the end
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "ChessBoard.h"
+#include "MoveList.h"
+#include "StateInfo.h"
+#include "Stats.h"
+
+using namespace std;
+
+/* A position with the number of leaf nodes it has at a depth
+ */
+struct PerftTest {
+	const char* name; //common name of the position
+	const char* FENstring; //position in Forsyth-Edwards Notation
+	int depth; //depth to count to
+	uint64_t nodes; //expected number of leaf nodes
+};
+
+//standard positions that cover castling, en passant, promotions, pins and checks
+static const PerftTest referenceTests[] = {
+	{"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609},
+	{"Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+	 4, 4085603},
+	{"position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083},
+	{"position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+	 5, 15833292},
+	{"position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+	{"position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+	 4, 3894594},
+};
+
+/******************* Class PerftHash *******************/
+
+/* Table of the leaf counts of subtrees, keyed by position hash and depth, that threads
+ * share without locks: each entry stores its key XORed with its data, so an entry torn
+ * by two threads writing at once fails the check and is ignored
+ */
+class PerftHash {
+	public:
+		/* Creates an instance of an empty PerftHash
+		 *
+		 * @param megabytes: size of the table, rounded down to a power of two entries
+		 */
+		PerftHash(size_t megabytes) {
+			size_t count = 1;
+			while (count * 2 * sizeof(Entry) <= megabytes << 20) {
+				count *= 2;
+			}
+			entries = vector<Entry>(count);
+			mask = count - 1;
+		}
+
+		/* Looks up the leaf count of a subtree
+		 *
+		 * @param key: hash of the position at the root of the subtree
+		 * @param depth: depth of the subtree
+		 * @param nodes: set to the leaf count if it is found
+		 * @returns: whether the leaf count was found
+		 */
+		bool probe(uint64_t key, int depth, uint64_t& nodes) const {
+			const Entry& entry = entries[key & mask];
+			uint64_t data = entry.data.load(memory_order_relaxed);
+			uint64_t check = entry.check.load(memory_order_relaxed);
+			if ((check ^ data) != key || int(data & 0xFF) != depth) {
+				return false;
+			}
+			nodes = data >> 8;
+			return true;
+		}
+
+		/* Stores the leaf count of a subtree, replacing whatever was in its entry
+		 *
+		 * @param key: hash of the position at the root of the subtree
+		 * @param depth: depth of the subtree
+		 * @param nodes: leaf count of the subtree
+		 */
+		void store(uint64_t key, int depth, uint64_t nodes) {
+			Entry& entry = entries[key & mask];
+			uint64_t data = nodes << 8 | uint64_t(depth);
+			entry.data.store(data, memory_order_relaxed);
+			entry.check.store(key ^ data, memory_order_relaxed);
+		}
+
+	private:
+		struct Entry {
+			atomic<uint64_t> check; //key XORed with data
+			atomic<uint64_t> data; //leaf count in the top 56 bits, depth in the low 8
+		};
+		vector<Entry> entries; //the table, a power of two entries long
+		size_t mask; //number of entries minus one, to index with the low bits of a key
+};
+
+/* Counts the leaf nodes below a position, making and undoing each move
+ *
+ * @param position: the position, left unchanged
+ * @param depth: number of moves to look ahead (at least 1)
+ * @param hash: table of subtree counts to use, or NULL
+ * @returns: the number of leaf nodes
+ */
+static uint64_t perft(Position& position, int depth, PerftHash* hash) {
+	MoveList moves;
+	position.generateLegalMoves(moves);
+	//the moves one ply from the leaves are the leaves, so count them without making them
+	if (depth == 1) {
+		return moves.size();
+	}
+	uint64_t nodes = 0;
+	if (hash && hash->probe(position.getKey(), depth, nodes)) {
+		return nodes;
+	}
+	StateInfo state;
+	for (Move move : moves) {
+		position.doMove(move, state);
+		nodes += perft(position, depth - 1, hash);
+		position.undoMove(state);
+	}
+	if (hash) {
+		hash->store(position.getKey(), depth, nodes);
+	}
+	return nodes;
+}
+
+/* A subtree two plies below the root, counted by whichever thread takes it first
+ */
+struct PerftTask {
+	Position position; //the position after a root move and a reply
+	int rootIndex; //index of the root move in the root MoveList
+};
+
+/* Counts the leaf nodes under each legal move of a position, splitting the first two
+ * plies into tasks that threads take from a shared counter until none are left
+ *
+ * @param root: the position
+ * @param depth: number of moves to look ahead (at least 1)
+ * @param moves: filled with the legal moves of the position
+ * @param counts: set to the leaf count under each move, in the order of moves
+ * @param threads: number of threads to count with
+ * @param hash: table of subtree counts to share between threads, or NULL
+ */
+static void countNodes(const Position& root, int depth, MoveList& moves, uint64_t counts[],
+					   int threads, PerftHash* hash) {
+	root.generateLegalMoves(moves);
+	//the move itself is the only leaf below it at depth 1
+	if (depth == 1) {
+		for (int index = 0; index < moves.size(); index++) {
+			counts[index] = 1;
+		}
+		return;
+	}
+	//make a copy of the position for each reply to each root move
+	vector<PerftTask> tasks;
+	MoveList replies;
+	for (int index = 0; index < moves.size(); index++) {
+		Position child = root;
+		child.doMove(moves[index]);
+		child.generateLegalMoves(replies);
+		counts[index] = (depth == 2) ? replies.size() : 0;
+		for (int reply = 0; depth > 2 && reply < replies.size(); reply++) {
+			tasks.push_back(PerftTask{child, index});
+			tasks.back().position.doMove(replies[reply]);
+		}
+	}
+	vector<atomic<uint64_t>> taskCounts(tasks.size());
+	atomic<size_t> nextTask(0);
+	//each thread counts the next task no thread has taken, until none are left
+	auto work = [&]() {
+		for (size_t task; (task = nextTask.fetch_add(1)) < tasks.size(); ) {
+			taskCounts[task] = perft(tasks[task].position, depth - 2, hash);
+		}
+	};
+	vector<thread> workers;
+	for (int thread = 1; thread < threads; thread++) {
+		workers.emplace_back(work);
+	}
+	work();
+	for (thread& worker : workers) {
+		worker.join();
+	}
+	//add each task's count to its root move
+	for (size_t task = 0; task < tasks.size(); task++) {
+		counts[tasks[task].rootIndex] += taskCounts[task];
+	}
+}
+
+/* Loads a position through a ChessBoard without printing the load message
+ *
+ * @param board: the ChessBoard to load into
+ * @param FENstring: position in Forsyth-Edwards Notation
+ * @returns: whether the position was loaded
+ */
+static bool loadQuietly(ChessBoard& board, const char* FENstring) {
+	streambuf* output = cout.rdbuf(NULL);
+	ChessBoard::FEN_STATUS status = board.loadState(FENstring);
+	cout.rdbuf(output);
+	return status == ChessBoard::LOADED;
+}
+
+/* Gets the number of seconds since a time
+ *
+ * @param start: the time to measure from
+ * @returns: the seconds elapsed
+ */
+static double secondsSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/* Prints the number of leaf nodes under each legal move of a position, then the total
+ *
+ * @param FENstring: position in Forsyth-Edwards Notation
+ * @param depth: number of moves to look ahead (at least 1)
+ * @param threads: number of threads to count with
+ * @param hash: table of subtree counts to use, or NULL
+ * @returns: whether the FEN string was valid
+ */
+static bool divide(const char* FENstring, int depth, int threads, PerftHash* hash) {
+	ChessBoard board;
+	if (!loadQuietly(board, FENstring)) {
+		cerr << "Invalid FEN string: " << FENstring << endl;
+		return false;
+	}
+	MoveList moves;
+	uint64_t counts[MoveList::CAPACITY];
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	countNodes(board, depth, moves, counts, threads, hash);
+	double seconds = secondsSince(start);
+	uint64_t total = 0;
+	for (int index = 0; index < moves.size(); index++) {
+		cout << moves[index] << ": " << counts[index] << '\n';
+		total += counts[index];
+	}
+	cout << "\nMoves: " << moves.size() << "\nNodes: " << total << "\nTime: " << seconds
+		 << " s\nNPS: " << uint64_t(total / seconds) << endl;
+	return true;
+}
+
+/* Counts the leaf nodes of each reference position and checks them against the
+ * expected counts
+ *
+ * @param threads: number of threads to count with
+ * @param hash: table of subtree counts to use, or NULL
+ * @returns: whether every count matched
+ */
+static bool runReferenceTests(int threads, PerftHash* hash) {
+	bool passed = true;
+	uint64_t totalNodes = 0;
+	double totalSeconds = 0;
+	for (const PerftTest& test : referenceTests) {
+		ChessBoard board;
+		loadQuietly(board, test.FENstring);
+		MoveList moves;
+		uint64_t counts[MoveList::CAPACITY];
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		countNodes(board, test.depth, moves, counts, threads, hash);
+		double seconds = secondsSince(start);
+		uint64_t nodes = 0;
+		for (int index = 0; index < moves.size(); index++) {
+			nodes += counts[index];
+		}
+		totalNodes += nodes;
+		totalSeconds += seconds;
+		//print the result and whether it matches
+		cout << (nodes == test.nodes ? "OK   " : "FAIL ") << test.name << " depth "
+			 << test.depth << ": " << nodes;
+		if (nodes != test.nodes) {
+			cout << " (expected " << test.nodes << ")";
+			passed = false;
+		}
+		cout << ", " << seconds << " s, " << uint64_t(nodes / seconds) << " NPS\n";
+	}
+	cout << "\nNodes: " << totalNodes << "\nTime: " << totalSeconds << " s\nNPS: "
+		 << uint64_t(totalNodes / totalSeconds) << endl;
+	return passed;
+}
+
+int main(int argc, char* argv[]) {
+	int threads = 1, hashMegabytes = 0, depth = 0;
+	const char* FENstring = referenceTests[0].FENstring;
+	const char* statsFormat = NULL;
+	//read the options, then the depth and FEN
+	int arg = 1;
+	for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+		if (strcmp(argv[arg], "-j") == 0) {
+			threads = atoi(argv[arg + 1]);
+		} else if (strcmp(argv[arg], "-H") == 0) {
+			hashMegabytes = atoi(argv[arg + 1]);
+		} else if (strcmp(argv[arg], "-s") == 0) {
+			statsFormat = argv[arg + 1];
+		} else {
+			threads = 0;
+		}
+	}
+	if (arg < argc) {
+		depth = atoi(argv[arg]);
+		if (arg + 1 < argc) {
+			FENstring = argv[arg + 1];
+		}
+	}
+	if (threads < 1 || hashMegabytes < 0 || (arg < argc && depth < 1)) {
+		cerr << "Usage: " << argv[0] << " [-j threads] [-H megabytes] [-s text|json] [depth [FEN]]"
+			 << endl;
+		return EXIT_FAILURE;
+	}
+	PerftHash* hash = hashMegabytes ? new PerftHash(hashMegabytes) : NULL;
+	//with no depth, check the reference positions
+	bool passed = true;
+	if (depth == 0) {
+		passed = runReferenceTests(threads, hash);
+	} else {
+		passed = divide(FENstring, depth, threads, hash);
+	}
+	delete hash;
+	//print the hot path counters, which are only kept when built with STATS=1
+	if (statsFormat) {
+#ifdef USE_STATS
+		cout << '\n';
+		Stats::dump(cout, strcmp(statsFormat, "json") == 0);
+#else
+		cerr << "Build with make STATS=1 to keep the hot path counters" << endl;
+#endif
+	}
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
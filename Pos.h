@@ -3,70 +3,141 @@
 #ifndef POS_H
 #define POS_H
 
+#include <cstdint>
 #include <iostream>
 
 /******************* Class Pos *******************/
 
+/* A square of the board stored as a 1 byte square index, row * 8 + col, from 0 (A8) to
+ * 63 (H1), or NONE if the position is invalid
+ */
 class Pos {
 	public:
-		int row; //row value of position 
-		int col; //column value of position
+		static const uint8_t NONE = 64; //square index of an invalid Pos
 
-		/* Creates an instance of Pos with uninitialized members
+		/* Creates an instance of an invalid Pos
 		 */
-		Pos();
+		constexpr Pos() : square(NONE) {}
 
 		/* Creates an instance of Pos
 		 *
-		 * @param _row: row of the position to intialise to
-		 * @param _col: column of the position to intialise to
+		 * @param _row: row of the position to intialise to, from 0 (rank 8) to 7
+		 * @param _col: column of the position to intialise to, from 0 (file A) to 7
 		 */
-		Pos(int _row, int _col);
+		constexpr Pos(int _row, int _col) : square(uint8_t(_row * 8 + _col)) {}
 
-		/* Creates an instance of Pos
+		/* Creates an instance of Pos, which is invalid unless src is a rank and file
+		 *
+		 * @param src: location of piece on the board in rank and file form, e.g. "E2"
+		 */
+		constexpr Pos(const char* src) : square(parseSquare(src)) {}
+
+		/* Creates an instance of Pos from a square index
+		 *
+		 * @param _square: square index from 0 (A8) to 63 (H1)
+		 * @returns: the Pos of the square
+		 */
+		static constexpr Pos fromSquare(int _square) {
+			Pos pos;
+			pos.square = uint8_t(_square);
+			return pos;
+		}
+
+		/* Getter for the square index
+		 *
+		 * @returns: square index from 0 (A8) to 63 (H1), or NONE
+		 */
+		constexpr int index() const {
+			return square;
+		}
+
+		/* Getter for the row
+		 *
+		 * @returns: row from 0 (rank 8) to 7 (rank 1)
+		 */
+		constexpr int row() const {
+			return square >> 3;
+		}
+
+		/* Getter for the column
 		 *
-		 * @param src: location of piece on the board in rank and file form
+		 * @returns: column from 0 (file A) to 7 (file H)
 		 */
-		Pos(const char* src);
-		
+		constexpr int col() const {
+			return square & 7;
+		}
+
+		/* Checks whether the position is a square of the board, without branching
+		 *
+		 * @returns: whether the position is valid
+		 */
+		constexpr bool isValid() const {
+			return square < NONE;
+		}
+
+		/* Writes the position in rank and file form
+		 *
+		 * @param text: set to the rank and file, e.g. "E2", at least 3 chars long
+		 */
+		constexpr void toString(char* text) const {
+			text[0] = char('A' + col());
+			text[1] = char('8' - row());
+			text[2] = '\0';
+		}
+
 		/* Overloads the == operator to compare if the other Pos is the same
 		 *
 		 * @param other: Pos to compare to
 		 * @returns: whether the two Pos are the same
 		 */
-		bool operator == (const Pos& other) const;
+		constexpr bool operator == (Pos other) const {
+			return square == other.square;
+		}
 
 		/* Overloads the != operator to compare if the other Pos is not the same
 		 *
 		 * @param other: Pos to compare to
 		 * @returns: whether the two Pos are different
 		 */
-		bool operator != (const Pos& other) const; 
+		constexpr bool operator != (Pos other) const {
+			return square != other.square;
+		}
 
-		/* Overloads the = operator to assign one Pos to another
-		 *
-		 * @param other: Pos to assign
-		 * @returns: a Pos that is the same as other
-		 */
-		Pos& operator = (const Pos& other);
-
-		/* Overloads the << operator to print Pos
+		/* Overloads the << operator to print Pos in rank and file form
 		 *
 		 * @param std::ostream&: output stream to write to
 		 * @param Pos&: Pos to print
 		 * @returns: the output stream
 		 */
-		friend std::ostream& operator << (std::ostream&, const Pos&); 
+		friend std::ostream& operator << (std::ostream&, const Pos&);
 
 	private:
-		/* Checks whether a rank and file location is valid and parses it into row and column
+		uint8_t square; //square index, row * 8 + col, or NONE
+
+		/* Checks whether a rank and file location is valid and parses it into a square
+		 * index
 		 *
 		 * @param src: rank and file location
-		 * @param pos: Pos to assign parsed row and column
-		 * @returns: Pos with parsed row and column
+		 * @returns: square index of the location, or NONE if it is invalid
 		 */
-		Pos& parsePosition(const char* src, Pos& pos);
+		static constexpr uint8_t parseSquare(const char* src) {
+			//validate src coordinates are on board, comparing as unsigned so that a
+			//char below 'A' or '1' wraps around to a large number
+			unsigned file = unsigned(src[0] - 'A');
+			if (file >= 8) {
+				return NONE;
+			}
+			unsigned rank = unsigned(src[1] - '1');
+			if (rank >= 8 || src[2] != '\0') {
+				return NONE;
+			}
+			//get the square index from src coordinates
+			return uint8_t((7 - rank) * 8 + file);
+		}
 };
 
-#endif
+static_assert(sizeof(Pos) == 1, "Pos must be 1 byte");
+static_assert(Pos("A8").index() == 0 && Pos("H1").index() == 63 && !Pos("I1").isValid(),
+			  "Pos must parse rank and file");
 
+#endif
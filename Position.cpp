@@ -0,0 +1,588 @@
+#include <type_traits>
+#include "Position.h"
+#include "Moves.h"
+#include "MoveList.h"
+#include "StateInfo.h"
+#include "Stats.h"
+
+//a Position must stay a plain value no bigger than two cache lines so it can be cloned cheaply
+static_assert(std::is_trivially_copyable<Position>::value, "Position must be trivially copyable");
+static_assert(sizeof(Position) <= 128, "Position must fit in two cache lines");
+
+/************* Compile time Zobrist key generation *************/
+
+/* Random keys for each feature of a position, XORed together to hash it
+ */
+struct ZobristKeys {
+	uint64_t pieces[2][6][64]; //a piece of each colour and type on each square
+	uint64_t castling[16]; //each castling availability mask
+	uint64_t epFile[8]; //the column of the en passant square
+	uint64_t side; //black to move
+};
+
+/* Steps a xorshift64* generator, which gives the same keys on every build
+ *
+ * @param seed: state of the generator, updated
+ * @returns: the next random number
+ */
+static constexpr uint64_t nextRandom(uint64_t& seed) {
+	seed ^= seed >> 12;
+	seed ^= seed << 25;
+	seed ^= seed >> 27;
+	return seed * 2685821657736338717ULL;
+}
+
+/* Builds every key in ZobristKeys
+ *
+ * @returns: the filled keys
+ */
+static constexpr ZobristKeys makeZobristKeys() {
+	ZobristKeys keys{};
+	uint64_t seed = 1070372;
+	for (int colour = 0; colour < 2; colour++) {
+		for (int type = 0; type < 6; type++) {
+			for (int square = 0; square < 64; square++) {
+				keys.pieces[colour][type][square] = nextRandom(seed);
+			}
+		}
+	}
+	//combine the keys of single castling rights so each mask hashes as its flags
+	uint64_t rights[4] = {};
+	for (int right = 0; right < 4; right++) {
+		rights[right] = nextRandom(seed);
+	}
+	for (int mask = 0; mask < 16; mask++) {
+		for (int right = 0; right < 4; right++) {
+			if (mask & (1 << right)) {
+				keys.castling[mask] ^= rights[right];
+			}
+		}
+	}
+	for (int file = 0; file < 8; file++) {
+		keys.epFile[file] = nextRandom(seed);
+	}
+	keys.side = nextRandom(seed);
+	return keys;
+}
+
+static constexpr ZobristKeys zobrist = makeZobristKeys();
+
+Position::Position() {
+	//fill the attack tables once, before the first position is used
+	static const bool attacksReady = (initAttacks(), true);
+	(void)attacksReady;
+	//clear the Bitboards
+	for (int type = PAWN; type <= KING; type++) {
+		byType[type] = 0;
+	}
+	byColour[BLACK] = byColour[WHITE] = 0;
+	checkers = pinned = 0;
+	key = 0;
+	//default white player to move, with no castling or en passant available
+	sideToMove = WHITE;
+	epSquare = -1;
+	castlingRights = 0;
+	halfmoveClock = 0;
+}
+
+Bitboard Position::occupied() const {
+	return byColour[BLACK] | byColour[WHITE];
+}
+
+Bitboard Position::pieces(COLOUR colour, PIECE type) const {
+	return byColour[colour] & byType[type];
+}
+
+Position::PIECE Position::typeOn(int square) const {
+	int type = PAWN;
+	while (!(byType[type] & squareBB(square))) {
+		type++;
+	}
+	return static_cast<PIECE>(type);
+}
+
+Position::COLOUR Position::getSideToMove() const {
+	return sideToMove;
+}
+
+Bitboard Position::getCheckers() const {
+	return checkers;
+}
+
+uint64_t Position::getKey() const {
+	return key;
+}
+
+int Position::getHalfmoveClock() const {
+	return halfmoveClock;
+}
+
+uint64_t Position::keyAfter(Move move) const {
+	COLOUR opponent = static_cast<COLOUR>(sideToMove ^ WHITE ^ BLACK);
+	int from = move.from(), to = move.to();
+	PIECE type = typeOn(from);
+	//move the piece, which a promoting pawn arrives on as the new piece
+	uint64_t after = key ^ zobrist.side ^ zobrist.pieces[sideToMove][type][from]
+		^ zobrist.pieces[sideToMove][(move.type() == Move::PROMOTION) ? move.promotion() : type][to];
+	//take any piece on the destination
+	if (byColour[opponent] & squareBB(to)) {
+		after ^= zobrist.pieces[opponent][typeOn(to)][to];
+	}
+	//lose any castling rights and the en passant square
+	after ^= zobrist.castling[castlingRights]
+		^ zobrist.castling[castlingRights & ~(castlingRightsLost(from) | castlingRightsLost(to))];
+	if (epSquare != -1) {
+		after ^= zobrist.epFile[epSquare & 7];
+	}
+	return after;
+}
+
+void Position::togglePiece(COLOUR colour, PIECE type, int square) {
+	//XOR the square into the piece's type and colour sets, and the piece into the hash
+	byType[type] ^= squareBB(square);
+	byColour[colour] ^= squareBB(square);
+	key ^= zobrist.pieces[colour][type][square];
+}
+
+uint64_t Position::computeKey() const {
+	uint64_t key = 0;
+	//hash every piece on the board
+	for (int colour = BLACK; colour <= WHITE; colour++) {
+		for (int type = PAWN; type <= KING; type++) {
+			for (Bitboard b = pieces(static_cast<COLOUR>(colour), static_cast<PIECE>(type)); b; ) {
+				key ^= zobrist.pieces[colour][type][popLsb(b)];
+			}
+		}
+	}
+	//hash the state that is not on the board
+	key ^= zobrist.castling[castlingRights];
+	if (epSquare != -1) {
+		key ^= zobrist.epFile[epSquare & 7];
+	}
+	if (sideToMove == BLACK) {
+		key ^= zobrist.side;
+	}
+	return key;
+}
+
+template <Position::COLOUR Them>
+Bitboard Position::attackersBy(int square, Bitboard occupied) const {
+	STATS_COUNT(ATTACKERS_BY);
+	constexpr COLOUR Us = (Them == WHITE) ? BLACK : WHITE;
+	//a piece attacks the square if the same piece on the square would attack it back
+	//(pawns are looked up with the opposite colour's attack direction)
+	return ((pawnAttacks(Us, square) & byType[PAWN])
+		  | (knightAttacks(square) & byType[KNIGHT])
+		  | (kingAttacks(square) & byType[KING])
+		  | (bishopAttacks(square, occupied) & (byType[BISHOP] | byType[QUEEN]))
+		  | (rookAttacks(square, occupied) & (byType[ROOK] | byType[QUEEN])))
+		  & byColour[Them];
+}
+
+Bitboard Position::pieceMoves(int square) const {
+	STATS_COUNT(PIECE_MOVES);
+	COLOUR colour = (byColour[WHITE] & squareBB(square)) ? WHITE : BLACK;
+	COLOUR opponent = static_cast<COLOUR>(colour ^ WHITE ^ BLACK);
+	Bitboard occupied = this->occupied();
+	Bitboard targets = 0;
+	//get the squares the piece attacks
+	switch (typeOn(square)) {
+		case PAWN: {
+			//pawns only move diagonally to take an opponent's piece
+			targets = pawnAttacks(colour, square) & byColour[opponent];
+			//pawns move forward onto an empty square if nothing is in the way
+			for (Bitboard pushes = pawnPushes(colour, square); pushes; ) {
+				int to = popLsb(pushes);
+				if (!((between(square, to) | squareBB(to)) & occupied)) {
+					targets |= squareBB(to);
+				}
+			}
+			return targets;
+		}
+		case KNIGHT:
+			targets = knightAttacks(square);
+			break;
+		case BISHOP:
+			targets = bishopAttacks(square, occupied);
+			break;
+		case ROOK:
+			targets = rookAttacks(square, occupied);
+			break;
+		case QUEEN:
+			targets = bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+			break;
+		case KING:
+			targets = kingAttacks(square);
+			break;
+	}
+	//pieces cannot move onto their own pieces
+	return targets & ~byColour[colour];
+}
+
+void Position::generateLegalMoves(MoveList& moves) const {
+	STATS_TIME(GENERATE_LEGAL_MOVES);
+	if (sideToMove == WHITE) {
+		generateLegalMoves<WHITE>(moves);
+	} else {
+		generateLegalMoves<BLACK>(moves);
+	}
+}
+
+template <Position::COLOUR Us>
+void Position::generateLegalMoves(MoveList& moves) const {
+	moves.clear();
+	int kingSquare = lsb(pieces(Us, KING));
+	//the king can step to any square around it not holding one of the player's pieces
+	addPieceMoves(moves, kingSquare, kingAttacks(kingSquare) & ~byColour[Us]);
+	//a player in check can only make moves that get out of check: only the king can
+	//move out of two checks, and other pieces must take the checking piece or move
+	//between it and the king, which a pinned piece can never do
+	Bitboard movers = byColour[Us] & ~squareBB(kingSquare);
+	Bitboard targets = ~byColour[Us];
+	if (checkers) {
+		movers = (checkers & (checkers - 1)) ? 0 : movers & ~pinned;
+		targets = checkers | between(kingSquare, lsb(checkers));
+	}
+	if (movers) {
+		Bitboard occupied = this->occupied();
+		addPawnMoves<Us>(moves, movers & byType[PAWN], targets);
+		for (Bitboard knights = movers & byType[KNIGHT]; knights; ) {
+			int from = popLsb(knights);
+			addPieceMoves(moves, from, knightAttacks(from) & targets);
+		}
+		for (Bitboard bishops = movers & (byType[BISHOP] | byType[QUEEN]); bishops; ) {
+			int from = popLsb(bishops);
+			addPieceMoves(moves, from, bishopAttacks(from, occupied) & targets);
+		}
+		//queens add their diagonal moves above and their straight moves here
+		for (Bitboard rooks = movers & (byType[ROOK] | byType[QUEEN]); rooks; ) {
+			int from = popLsb(rooks);
+			addPieceMoves(moves, from, rookAttacks(from, occupied) & targets);
+		}
+		//a checking pawn that has just moved two squares can also be taken en passant
+		addEnPassantMoves<Us>(moves);
+	}
+	if (!checkers) {
+		addCastlingMoves<Us>(moves);
+	}
+	//remove the moves that leave the player's king in check
+	for (int index = 0; index < moves.size(); ) {
+		if (isLegal<Us>(moves[index])) {
+			index++;
+		} else {
+			moves.remove(index);
+		}
+	}
+}
+
+/* Shifts every square of a Bitboard a number of squares towards the higher indices, or
+ * towards the lower indices if the number is negative
+ *
+ * @param b: the Bitboard to shift
+ * @returns: the shifted Bitboard
+ */
+template <int Step>
+static Bitboard shiftBy(Bitboard b) {
+	if constexpr (Step > 0) {
+		return b << Step;
+	} else {
+		return b >> -Step;
+	}
+}
+
+/* Adds a pawn move to each target square from the square Step behind it, adding every
+ * promotion when the target is on the last row
+ *
+ * @param moves: MoveList to add to
+ * @param targets: Bitboard of destination squares
+ */
+template <int Step>
+static void addPawnMovesBy(MoveList& moves, Bitboard targets) {
+	//a pawn reaching the last row becomes a queen, rook, bishop or knight
+	for (Bitboard promotions = targets & (ROW_0_BB | ROW_7_BB); promotions; ) {
+		int to = popLsb(promotions);
+		for (int type = Position::QUEEN; type >= Position::KNIGHT; type--) {
+			moves.add(Move(to - Step, to, Move::PROMOTION, static_cast<Position::PIECE>(type)));
+		}
+	}
+	for (targets &= ~(ROW_0_BB | ROW_7_BB); targets; ) {
+		int to = popLsb(targets);
+		moves.add(Move(to - Step, to));
+	}
+}
+
+template <Position::COLOUR Us>
+void Position::addPawnMoves(MoveList& moves, Bitboard pawns, Bitboard targets) const {
+	constexpr COLOUR Them = (Us == WHITE) ? BLACK : WHITE;
+	//white pawns move towards row 0, black pawns towards row 7
+	constexpr int Up = (Us == WHITE) ? -8 : 8;
+	//pawns that have moved one square from their start row can move another
+	constexpr Bitboard PushedRow = (Us == WHITE) ? ROW_0_BB << 40 : ROW_0_BB << 16;
+	Bitboard empty = ~occupied();
+	//pawns move forward onto empty squares
+	Bitboard singles = shiftBy<Up>(pawns) & empty;
+	Bitboard doubles = shiftBy<Up>(singles & PushedRow) & empty;
+	addPawnMovesBy<Up>(moves, singles & targets);
+	addPawnMovesBy<2 * Up>(moves, doubles & targets);
+	//pawns only move diagonally to take an opponent's piece, and cannot wrap around
+	//the edge of the board
+	Bitboard takeable = byColour[Them] & targets;
+	addPawnMovesBy<Up - 1>(moves, shiftBy<Up - 1>(pawns & ~FILE_A_BB) & takeable);
+	addPawnMovesBy<Up + 1>(moves, shiftBy<Up + 1>(pawns & ~FILE_H_BB) & takeable);
+}
+
+void Position::addPieceMoves(MoveList& moves, int from, Bitboard targets) const {
+	//add a move to each square the piece can move to
+	while (targets) {
+		moves.add(Move(from, popLsb(targets)));
+	}
+}
+
+template <Position::COLOUR Us>
+void Position::addEnPassantMoves(MoveList& moves) const {
+	constexpr COLOUR Them = (Us == WHITE) ? BLACK : WHITE;
+	if (epSquare == -1) {
+		return;
+	}
+	//the pawns that can take en passant attack epSquare, so stand where an opponent
+	//pawn on epSquare would attack
+	for (Bitboard takers = pawnAttacks(Them, epSquare) & pieces(Us, PAWN); takers; ) {
+		moves.add(Move(popLsb(takers), epSquare, Move::EN_PASSANT));
+	}
+}
+
+void Position::addCastlingMoves(MoveList& moves) const {
+	if (sideToMove == WHITE) {
+		addCastlingMoves<WHITE>(moves);
+	} else {
+		addCastlingMoves<BLACK>(moves);
+	}
+}
+
+template <Position::COLOUR Us>
+void Position::addCastlingMoves(MoveList& moves) const {
+	constexpr COLOUR Them = (Us == WHITE) ? BLACK : WHITE;
+	constexpr int HomeRow = (Us == WHITE) ? 56 : 0;
+	constexpr int KingSquare = HomeRow + 4;
+	constexpr int Kingside = (Us == WHITE) ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+	Bitboard occupied = this->occupied();
+	//the king must be on its start square and not in check
+	if (!(pieces(Us, KING) & squareBB(KingSquare)) || attackersBy<Them>(KingSquare, occupied)) {
+		return;
+	}
+	//kingside castling moves the king to column 6, queenside castling to column 2
+	const int rights[2] = {Kingside, Kingside << 1};
+	const int rookSquares[2] = {HomeRow + 7, HomeRow};
+	const int kingDests[2] = {HomeRow + 6, HomeRow + 2};
+	for (int side = 0; side < 2; side++) {
+		//the rook must still be in its corner with nothing between it and the king
+		if (!(castlingRights & rights[side])
+				|| !(pieces(Us, ROOK) & squareBB(rookSquares[side]))
+				|| (between(KingSquare, rookSquares[side]) & occupied)) {
+			continue;
+		}
+		//the king cannot pass through or move onto an attacked square
+		bool attacked = false;
+		Bitboard path = between(KingSquare, kingDests[side]) | squareBB(kingDests[side]);
+		while (path && !attacked) {
+			attacked = attackersBy<Them>(popLsb(path), occupied);
+		}
+		if (!attacked) {
+			moves.add(Move(KingSquare, kingDests[side], Move::CASTLING));
+		}
+	}
+}
+
+void Position::updateCheckInfo() {
+	checkers = pinned = 0;
+	//a position loaded without a king has no checks or pins
+	if (!pieces(sideToMove, KING)) {
+		return;
+	}
+	if (sideToMove == WHITE) {
+		updateCheckInfo<WHITE>();
+	} else {
+		updateCheckInfo<BLACK>();
+	}
+}
+
+template <Position::COLOUR Us>
+void Position::updateCheckInfo() {
+	constexpr COLOUR Them = (Us == WHITE) ? BLACK : WHITE;
+	int kingSquare = lsb(pieces(Us, KING));
+	Bitboard occupied = this->occupied();
+	checkers = attackersBy<Them>(kingSquare, occupied);
+	//get opponent sliding pieces that would attack the king on an empty board
+	Bitboard snipers = ((bishopAttacks(kingSquare, 0) & (byType[BISHOP] | byType[QUEEN]))
+					  | (rookAttacks(kingSquare, 0) & (byType[ROOK] | byType[QUEEN])))
+					  & byColour[Them];
+	pinned = 0;
+	while (snipers) {
+		//a single piece between the king and a sniper is pinned if it is the player's
+		Bitboard blockers = between(kingSquare, popLsb(snipers)) & occupied;
+		if (blockers && !(blockers & (blockers - 1))) {
+			pinned |= blockers & byColour[Us];
+		}
+	}
+}
+
+bool Position::isLegal(Move move) const {
+	return (sideToMove == WHITE) ? isLegal<WHITE>(move) : isLegal<BLACK>(move);
+}
+
+template <Position::COLOUR Us>
+bool Position::isLegal(Move move) const {
+	STATS_COUNT(IS_LEGAL);
+	constexpr COLOUR Them = (Us == WHITE) ? BLACK : WHITE;
+	//castling moves are only added when the king's path is not attacked
+	if (move.type() == Move::CASTLING) {
+		return true;
+	}
+	int from = move.from(), to = move.to();
+	int kingSquare = lsb(pieces(Us, KING));
+	//a king cannot move onto a square attacked through the square it leaves
+	if (from == kingSquare) {
+		return !attackersBy<Them>(to, occupied() ^ squareBB(from));
+	}
+	//en passant removes two pieces from a row, so check for attacks after the move
+	if (move.type() == Move::EN_PASSANT) {
+		int takenSquare = (Us == WHITE) ? to + 8 : to - 8;
+		Bitboard occupied = (this->occupied() ^ squareBB(from) ^ squareBB(takenSquare))
+							| squareBB(to);
+		return !(attackersBy<Them>(kingSquare, occupied) & ~squareBB(takenSquare));
+	}
+	if (checkers) {
+		//only the king can move out of two checks
+		if (checkers & (checkers - 1)) {
+			return false;
+		}
+		//otherwise the move must take the checking piece or block its path
+		if (!((between(kingSquare, lsb(checkers)) | checkers) & squareBB(to))) {
+			return false;
+		}
+	}
+	//a pinned piece can only move along the line through its king
+	return !(pinned & squareBB(from)) || (line(kingSquare, from) & squareBB(to));
+}
+
+int Position::castlingRightsLost(int square) {
+	//a king or rook moving from its start square, or a rook being taken on it, loses
+	//the castling availability that uses it
+	switch (square) {
+		case 0:
+			return BLACK_QUEENSIDE;
+		case 4:
+			return BLACK_KINGSIDE | BLACK_QUEENSIDE;
+		case 7:
+			return BLACK_KINGSIDE;
+		case 56:
+			return WHITE_QUEENSIDE;
+		case 60:
+			return WHITE_KINGSIDE | WHITE_QUEENSIDE;
+		case 63:
+			return WHITE_KINGSIDE;
+	}
+	return 0;
+}
+
+void Position::doMove(Move move, StateInfo& state) {
+	STATS_COUNT(DO_MOVE);
+	COLOUR opponent = static_cast<COLOUR>(sideToMove ^ WHITE ^ BLACK);
+	int from = move.from(), to = move.to();
+	PIECE type = typeOn(from);
+	//save the state the move changes
+	state.move = move;
+	state.captured = -1;
+	state.checkers = checkers;
+	state.pinned = pinned;
+	state.key = key;
+	state.epSquare = epSquare;
+	state.castlingRights = castlingRights;
+	state.halfmoveClock = halfmoveClock;
+	//take any piece on the destination, or beside the source en passant
+	int takenSquare = to;
+	if (move.type() == Move::EN_PASSANT) {
+		takenSquare = (sideToMove == WHITE) ? to + 8 : to - 8;
+	}
+	if (byColour[opponent] & squareBB(takenSquare)) {
+		state.captured = typeOn(takenSquare);
+		togglePiece(opponent, static_cast<PIECE>(state.captured), takenSquare);
+	}
+	//a castling king's rook moves to the square the king passes over
+	if (move.type() == Move::CASTLING) {
+		togglePiece(sideToMove, ROOK, (to > from) ? to + 1 : to - 2);
+		togglePiece(sideToMove, ROOK, (from + to) / 2);
+	}
+	//a promoting pawn is replaced by the new piece
+	togglePiece(sideToMove, type, from);
+	togglePiece(sideToMove, (move.type() == Move::PROMOTION) ? move.promotion() : type, to);
+	//a capture or pawn move resets the halfmove clock
+	if (state.captured != -1 || type == PAWN) {
+		halfmoveClock = 0;
+	} else {
+		halfmoveClock++;
+	}
+	//moving a king or rook from its start square, or taking a rook on it, loses castling
+	key ^= zobrist.castling[castlingRights];
+	castlingRights &= ~(castlingRightsLost(from) | castlingRightsLost(to));
+	key ^= zobrist.castling[castlingRights];
+	//a pawn moving two squares can be taken en passant on the square it passes over
+	if (epSquare != -1) {
+		key ^= zobrist.epFile[epSquare & 7];
+	}
+	epSquare = -1;
+	if (type == PAWN && (to - from == 16 || from - to == 16)
+			&& (pawnAttacks(sideToMove, (from + to) / 2) & pieces(opponent, PAWN))) {
+		epSquare = (from + to) / 2;
+		key ^= zobrist.epFile[epSquare & 7];
+	}
+	sideToMove = opponent;
+	key ^= zobrist.side;
+	//get the checks and pins of the player who now has the move
+	updateCheckInfo();
+}
+
+void Position::doMove(Move move) {
+	//a copy that is thrown away after the move does not need the state to undo it
+	StateInfo state;
+	doMove(move, state);
+}
+
+void Position::undoMove(const StateInfo& state) {
+	STATS_COUNT(UNDO_MOVE);
+	Move move = state.move;
+	int from = move.from(), to = move.to();
+	COLOUR opponent = sideToMove;
+	sideToMove = static_cast<COLOUR>(sideToMove ^ WHITE ^ BLACK);
+	//move the piece back, putting back the pawn a piece was promoted from
+	PIECE type = typeOn(to);
+	togglePiece(sideToMove, type, to);
+	togglePiece(sideToMove, (move.type() == Move::PROMOTION) ? PAWN : type, from);
+	//put back a castling king's rook
+	if (move.type() == Move::CASTLING) {
+		togglePiece(sideToMove, ROOK, (from + to) / 2);
+		togglePiece(sideToMove, ROOK, (to > from) ? to + 1 : to - 2);
+	}
+	//put back the piece taken
+	if (state.captured != -1) {
+		int takenSquare = to;
+		if (move.type() == Move::EN_PASSANT) {
+			takenSquare = (sideToMove == WHITE) ? to + 8 : to - 8;
+		}
+		togglePiece(opponent, static_cast<PIECE>(state.captured), takenSquare);
+	}
+	//restore the state before the move
+	checkers = state.checkers;
+	pinned = state.pinned;
+	key = state.key;
+	epSquare = state.epSquare;
+	castlingRights = state.castlingRights;
+	halfmoveClock = state.halfmoveClock;
+}
+
+std::ostream& operator << (std::ostream& output, const Position::COLOUR& colour) {	
+	//setup an array of strings corresponding to the COLOURS enum
+	const char* colours[] = {"Black", "White"};
+	//print enum using COLOUR as index
+	return output << colours[colour];
+}
@@ -0,0 +1,275 @@
+/* Position.h - header file for the class Position */
+
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <iostream>
+#include "Bitboard.h"
+
+/******************* Class Position *******************/
+
+class Move;
+class MoveList;
+struct StateInfo;
+
+/* The pieces and state of a chess position as plain Bitboards and numbers, with no
+ * pointers, so it can be copied with memcpy (a thread can clone a position and search
+ * it on its own, making moves on copies instead of unmaking them)
+ */
+class Position {
+	public:
+		/* Represents the colour of the players and pieces
+		 *
+		 * @value BLACK: black player or black piece
+		 * @value WHITE: white player or white piece
+		 */
+		enum COLOUR {BLACK, WHITE};
+
+		/* Represents the type of a piece, used to index the piece Bitboards
+		 *
+		 * @value PAWN: pawn
+		 * @value KNIGHT: knight
+		 * @value BISHOP: bishop
+		 * @value ROOK: rook
+		 * @value QUEEN: queen
+		 * @value KING: king
+		 */
+		enum PIECE {PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING};
+
+		/* Represents a castling availability, combined as flags in a 4-bit mask
+		 *
+		 * @value WHITE_KINGSIDE: White can castle kingside (K)
+		 * @value WHITE_QUEENSIDE: White can castle queenside (Q)
+		 * @value BLACK_KINGSIDE: Black can castle kingside (k)
+		 * @value BLACK_QUEENSIDE: Black can castle queenside (q)
+		 */
+		enum CASTLING_RIGHT {WHITE_KINGSIDE = 1, WHITE_QUEENSIDE = 2,
+							 BLACK_KINGSIDE = 4, BLACK_QUEENSIDE = 8};
+
+		/* Creates an instance of an empty Position with White to move
+		 */
+		Position();
+
+		/* Overloads the << operator to print a COLOUR
+		 *
+		 * @param std::ostream&: the output stream to write to
+		 * @param COLOUR&: COLOUR to be printed
+		 * @returns: the output stream
+		 */
+		friend std::ostream& operator << (std::ostream&, const COLOUR&);
+
+		/* Gets the squares occupied by any piece
+		 *
+		 * @returns: Bitboard of all occupied squares
+		 */
+		Bitboard occupied() const;
+
+		/* Gets the pieces of a player and type
+		 *
+		 * @param colour: colour of the pieces
+		 * @param type: type of the pieces
+		 * @returns: Bitboard of the squares holding those pieces
+		 */
+		Bitboard pieces(COLOUR colour, PIECE type) const;
+
+		/* Gets the type of the piece on an occupied square
+		 *
+		 * @param square: square index of the piece
+		 * @returns: the piece's type
+		 */
+		PIECE typeOn(int square) const;
+
+		/* Getter for the player who has the move
+		 *
+		 * @returns: the player's colour
+		 */
+		COLOUR getSideToMove() const;
+
+		/* Getter for the pieces checking the player who has the move
+		 *
+		 * @returns: Bitboard of the checking pieces
+		 */
+		Bitboard getCheckers() const;
+
+		/* Getter for the hash of the position
+		 *
+		 * @returns: the hash
+		 */
+		uint64_t getKey() const;
+
+		/* Getter for the halfmove clock
+		 *
+		 * @returns: moves since the last capture or pawn move
+		 */
+		int getHalfmoveClock() const;
+
+		/* Works out the hash of the position after a move without making it, for
+		 * prefetching the position's table entry while the move is made. It does not
+		 * include the rook of a castling move, a pawn taken en passant or a new en
+		 * passant square, so it differs from the key after those moves
+		 *
+		 * @param move: a legal move
+		 * @returns: the hash after the move
+		 */
+		uint64_t keyAfter(Move move) const;
+
+		/* Fills a MoveList with every legal move of the player who has the move,
+		 * including castling, en passant and each promotion of a pawn
+		 *
+		 * @param moves: MoveList to fill, any moves already in it are removed
+		 */
+		void generateLegalMoves(MoveList& moves) const;
+
+		/* Gets the squares the piece on a square can move to by its movement rules,
+		 * ignoring castling, en passant and whether the move leaves its king in check
+		 *
+		 * @param square: square index of the piece
+		 * @returns: Bitboard of destination squares
+		 */
+		Bitboard pieceMoves(int square) const;
+
+		/* Adds the castling moves of the player who has the move, if their king and rook
+		 * have not moved, the squares between them are empty and the king does not start
+		 * in, pass through or end in check
+		 *
+		 * @param moves: MoveList to add to
+		 */
+		void addCastlingMoves(MoveList& moves) const;
+
+		/* Checks whether a move by its movement rules does not leave the player's own
+		 * king in check, using checkers and pinned so only king moves and en passant
+		 * need to look for attacks
+		 *
+		 * @param move: the move to check
+		 * @returns: whether the move is legal
+		 */
+		bool isLegal(Move move) const;
+
+		/* Makes a legal move, saving what is needed to undo it
+		 *
+		 * @param move: a move from generateLegalMoves
+		 * @param state: StateInfo to save the state before the move in
+		 */
+		void doMove(Move move, StateInfo& state);
+
+		/* Makes a legal move on a copy of a position that will not be undone
+		 *
+		 * @param move: a move from generateLegalMoves
+		 */
+		void doMove(Move move);
+
+		/* Undoes the last move made
+		 *
+		 * @param state: the StateInfo saved when the move was made
+		 */
+		void undoMove(const StateInfo& state);
+
+	protected:
+		Bitboard byType[6]; //squares occupied by each piece type (indexed by PIECE)
+		Bitboard byColour[2]; //squares occupied by each player (indexed by COLOUR)
+		Bitboard checkers; //opponent pieces attacking the king of the player who has the move
+		Bitboard pinned; //pieces of the player who has the move that shield their king
+		uint64_t key; //Zobrist hash of the position
+		COLOUR sideToMove; //Player who has the move
+		int8_t epSquare; //square a pawn can move to taking en passant, or -1 if there is none
+		uint8_t castlingRights; //castling availability (CASTLING_RIGHT flags)
+		uint16_t halfmoveClock; //moves since the last capture or pawn move
+
+		/* Adds or removes a piece from the Bitboards and the hash
+		 *
+		 * @param colour: colour of the piece
+		 * @param type: type of the piece
+		 * @param square: square index of the piece
+		 */
+		void togglePiece(COLOUR colour, PIECE type, int square);
+
+		/* Hashes the whole position from scratch, which doMove otherwise keeps up to
+		 * date by XORing in only what each move changes
+		 *
+		 * @returns: the Zobrist key of the pieces, player who has the move, castling
+		 *			 availability and en passant column
+		 */
+		uint64_t computeKey() const;
+
+		/* Sets checkers and pinned for the player who has the move, must be called
+		 * whenever the pieces or the player who has the move change
+		 */
+		void updateCheckInfo();
+
+	private:
+		/* The colour-specific routines below are templates on the player Us who has the
+		 * move, so pawn directions, home rows and the opponent are known at compile time.
+		 * The public functions pick the instance for sideToMove once per call
+		 */
+
+		/* Sets checkers and pinned for Us, the player who has the move
+		 */
+		template <COLOUR Us>
+		void updateCheckInfo();
+
+		/* Gets the pieces of a player that attack a square
+		 *
+		 * @param square: square index to check
+		 * @param occupied: Bitboard of occupied squares that block sliding pieces
+		 * @returns: Bitboard of the attacking pieces of Them
+		 */
+		template <COLOUR Them>
+		Bitboard attackersBy(int square, Bitboard occupied) const;
+
+		/* Fills a MoveList with every legal move of Us, the player who has the move
+		 *
+		 * @param moves: MoveList to fill, any moves already in it are removed
+		 */
+		template <COLOUR Us>
+		void generateLegalMoves(MoveList& moves) const;
+
+		/* Adds the pawn moves of Us onto target squares, including each promotion,
+		 * working on all the pawns at once by shifting their Bitboard
+		 *
+		 * @param moves: MoveList to add to
+		 * @param pawns: Bitboard of the pawns that can move
+		 * @param targets: Bitboard of the squares the pawns may move to or take on
+		 */
+		template <COLOUR Us>
+		void addPawnMoves(MoveList& moves, Bitboard pawns, Bitboard targets) const;
+
+		/* Adds a move from a square to each target square
+		 *
+		 * @param moves: MoveList to add to
+		 * @param from: square index of the piece
+		 * @param targets: Bitboard of destination squares
+		 */
+		void addPieceMoves(MoveList& moves, int from, Bitboard targets) const;
+
+		/* Adds the moves of Us, the player who has the move, that take en passant
+		 *
+		 * @param moves: MoveList to add to
+		 */
+		template <COLOUR Us>
+		void addEnPassantMoves(MoveList& moves) const;
+
+		/* Adds the castling moves of Us, the player who has the move (see addCastlingMoves)
+		 *
+		 * @param moves: MoveList to add to
+		 */
+		template <COLOUR Us>
+		void addCastlingMoves(MoveList& moves) const;
+
+		/* Checks whether a move of Us, the player who has the move, is legal (see isLegal)
+		 *
+		 * @param move: the move to check
+		 * @returns: whether the move is legal
+		 */
+		template <COLOUR Us>
+		bool isLegal(Move move) const;
+
+		/* Gets the castling availability lost when a piece moves from or to a square
+		 *
+		 * @param square: square index of the source or destination
+		 * @returns: CASTLING_RIGHT flags of the king or rook that starts on the square
+		 */
+		static int castlingRightsLost(int square);
+};
+
+#endif
@@ -0,0 +1,504 @@
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "Search.h"
+#include "StateInfo.h"
+
+using namespace std;
+
+//value of each piece type in centipawns (indexed by Position::PIECE)
+static const int pieceValues[6] = {100, 320, 330, 500, 900, 0};
+
+//bonus of each piece type on each square for White, from A8 to H1 (Black's squares are
+//mirrored), with the king's in the middlegame and the endgame
+static const int pieceSquares[6][64] = {
+	{//pawn
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	 50,  50,  50,  50,  50,  50,  50,  50,
+	 10,  10,  20,  30,  30,  20,  10,  10,
+	  5,   5,  10,  25,  25,  10,   5,   5,
+	  0,   0,   0,  20,  20,   0,   0,   0,
+	  5,  -5, -10,   0,   0, -10,  -5,   5,
+	  5,  10,  10, -20, -20,  10,  10,   5,
+	  0,   0,   0,   0,   0,   0,   0,   0},
+	{//knight
+	-50, -40, -30, -30, -30, -30, -40, -50,
+	-40, -20,   0,   0,   0,   0, -20, -40,
+	-30,   0,  10,  15,  15,  10,   0, -30,
+	-30,   5,  15,  20,  20,  15,   5, -30,
+	-30,   0,  15,  20,  20,  15,   0, -30,
+	-30,   5,  10,  15,  15,  10,   5, -30,
+	-40, -20,   0,   5,   5,   0, -20, -40,
+	-50, -40, -30, -30, -30, -30, -40, -50},
+	{//bishop
+	-20, -10, -10, -10, -10, -10, -10, -20,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   5,  10,  10,   5,   0, -10,
+	-10,   5,   5,  10,  10,   5,   5, -10,
+	-10,   0,  10,  10,  10,  10,   0, -10,
+	-10,  10,  10,  10,  10,  10,  10, -10,
+	-10,   5,   0,   0,   0,   0,   5, -10,
+	-20, -10, -10, -10, -10, -10, -10, -20},
+	{//rook
+	  0,   0,   0,   0,   0,   0,   0,   0,
+	  5,  10,  10,  10,  10,  10,  10,   5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	 -5,   0,   0,   0,   0,   0,   0,  -5,
+	  0,   0,   0,   5,   5,   0,   0,   0},
+	{//queen
+	-20, -10, -10,  -5,  -5, -10, -10, -20,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   5,   5,   5,   5,   0, -10,
+	 -5,   0,   5,   5,   5,   5,   0,  -5,
+	  0,   0,   5,   5,   5,   5,   0,  -5,
+	-10,   5,   5,   5,   5,   5,   0, -10,
+	-10,   0,   5,   0,   0,   0,   0, -10,
+	-20, -10, -10,  -5,  -5, -10, -10, -20},
+	{//king in the middlegame, sheltering behind its pawns
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-20, -30, -30, -40, -40, -30, -30, -20,
+	-10, -20, -20, -20, -20, -20, -20, -10,
+	 20,  20,   0,   0,   0,   0,  20,  20,
+	 20,  30,  10,   0,   0,  10,  30,  20},
+};
+
+//bonus of the king on each square in the endgame, when it should come to the centre
+static const int kingEndgameSquares[64] = {
+	-50, -40, -30, -20, -20, -30, -40, -50,
+	-30, -20, -10,   0,   0, -10, -20, -30,
+	-30, -10,  20,  30,  30,  20, -10, -30,
+	-30, -10,  30,  40,  40,  30, -10, -30,
+	-30, -10,  30,  40,  40,  30, -10, -30,
+	-30, -10,  20,  30,  30,  20, -10, -30,
+	-30, -30,   0,   0,   0,   0, -30, -30,
+	-50, -30, -30, -30, -30, -30, -30, -50,
+};
+
+//weight of each piece type in the game phase, which is 24 with every piece on the board
+//and 0 with only pawns and kings (indexed by Position::PIECE)
+static const int phaseWeights[6] = {0, 1, 1, 2, 4, 0};
+static const int MAX_PHASE = 24;
+
+//order scores of moves, so the table's best move comes first, then the previous
+//principal variation, then captures and promotions, then killer moves, then the other
+//quiet moves
+static const int TABLE_SCORE = 1 << 21;
+static const int PV_SCORE = 1 << 20;
+static const int CAPTURE_SCORE = 1 << 16;
+static const int KILLER_SCORE = 1 << 15;
+static const int TRIED = -1; //order score of a move that has been tried
+
+/* Checks whether a move captures a piece
+ *
+ * @param position: the position the move is made in
+ * @param move: the move
+ * @returns: whether it is a capture, including en passant
+ */
+static bool isCapture(const Position& position, Move move) {
+	return move.type() == Move::EN_PASSANT || (position.occupied() & squareBB(move.to()));
+}
+
+/* Converts a score from the root's view of mate to the view of the position it is
+ * stored for, so a mate stored at one ply is right when read back at another
+ *
+ * @param score: score of the position
+ * @param ply: plies from the root
+ * @returns: the score with a mate counted from the position
+ */
+static int scoreToTable(int score, int ply) {
+	if (score >= Search::MATE - Search::MAX_PLY) {
+		return score + ply;
+	}
+	if (score <= -(Search::MATE - Search::MAX_PLY)) {
+		return score - ply;
+	}
+	return score;
+}
+
+/* Converts a score read from the table back to the root's view of mate
+ *
+ * @param score: score stored for the position
+ * @param ply: plies from the root
+ * @returns: the score with a mate counted from the root
+ */
+static int scoreFromTable(int score, int ply) {
+	if (score >= Search::MATE - Search::MAX_PLY) {
+		return score - ply;
+	}
+	if (score <= -(Search::MATE - Search::MAX_PLY)) {
+		return score + ply;
+	}
+	return score;
+}
+
+/* Takes the untried move with the highest order score, marking it as tried
+ *
+ * @param moves: the moves
+ * @param scores: order score of each move
+ * @returns: index of the move, or -1 if every move has been tried
+ */
+static int pickMove(const MoveList& moves, int scores[]) {
+	int best = -1;
+	for (int index = 0; index < moves.size(); index++) {
+		if (scores[index] != TRIED && (best == -1 || scores[index] > scores[best])) {
+			best = index;
+		}
+	}
+	if (best != -1) {
+		scores[best] = TRIED;
+	}
+	return best;
+}
+
+Search::Search(const Position& _position, TranspositionTable& _table)
+	: position(_position), table(_table), nodes(0), stopped(false), threadId(0), stop(NULL),
+	  totalNodes(NULL) {}
+
+int Search::evaluate(const Position& position) {
+	int score = 0;
+	int phase = 0;
+	int kingMiddlegame = 0;
+	int kingEndgame = 0;
+	for (int colour = Position::BLACK; colour <= Position::WHITE; colour++) {
+		int sign = (colour == Position::WHITE) ? 1 : -1;
+		//Black's pieces read White's tables upside down
+		int mirror = (colour == Position::WHITE) ? 0 : 56;
+		for (int type = Position::PAWN; type <= Position::KING; type++) {
+			Bitboard b = position.pieces(static_cast<Position::COLOUR>(colour),
+										 static_cast<Position::PIECE>(type));
+			phase += phaseWeights[type] * popCount(b);
+			while (b) {
+				int square = popLsb(b) ^ mirror;
+				if (type == Position::KING) {
+					kingMiddlegame += sign * pieceSquares[type][square];
+					kingEndgame += sign * kingEndgameSquares[square];
+				} else {
+					score += sign * (pieceValues[type] + pieceSquares[type][square]);
+				}
+			}
+		}
+	}
+	//blend the king's tables by how much material is left
+	phase = min(phase, MAX_PHASE);
+	score += (kingMiddlegame * phase + kingEndgame * (MAX_PHASE - phase)) / MAX_PHASE;
+	return (position.getSideToMove() == Position::WHITE) ? score : -score;
+}
+
+SearchResult Search::run(const SearchLimits& _limits, ostream* info, int threads) {
+	chrono::steady_clock::time_point searchStart = chrono::steady_clock::now();
+	table.newSearch();
+	atomic<bool> stop(false);
+	atomic<uint64_t> totalNodes(0);
+	//each helper searches its own copy of the root with its own killers and principal
+	//variation, sharing only the table, the stop flag and the node count
+	vector<SearchResult> helperResults(max(threads - 1, 0));
+	vector<thread> helpers;
+	for (int id = 1; id < threads; id++) {
+		helpers.emplace_back([&, id, root = position]() {
+			Search helper(root, table);
+			helperResults[id - 1] = helper.iterate(_limits, NULL, id, stop, totalNodes);
+		});
+	}
+	SearchResult result = iterate(_limits, info, 0, stop, totalNodes);
+	//the main thread has finished, so the helpers stop too
+	stop.store(true, memory_order_relaxed);
+	for (thread& helper : helpers) {
+		helper.join();
+	}
+	//a helper may have completed a deeper iteration than the main thread
+	for (const SearchResult& helperResult : helperResults) {
+		if (helperResult.depth > result.depth) {
+			result = helperResult;
+		}
+	}
+
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - searchStart).count();
+	result.nodes = totalNodes;
+	result.milliseconds = uint64_t(seconds * 1000);
+	result.nodesPerSecond = (seconds > 0) ? uint64_t(result.nodes / seconds) : 0;
+	return result;
+}
+
+SearchResult Search::iterate(const SearchLimits& _limits, ostream* info, int _threadId,
+							 atomic<bool>& _stop, atomic<uint64_t>& _totalNodes) {
+	limits = _limits;
+	start = chrono::steady_clock::now();
+	nodes = 0;
+	stopped = false;
+	threadId = _threadId;
+	stop = &_stop;
+	totalNodes = &_totalNodes;
+	fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, Move());
+	fill(previousPv, previousPv + MAX_PLY, Move());
+
+	SearchResult result = SearchResult();
+	MoveList moves;
+	position.generateLegalMoves(moves);
+	if (moves.size() == 0) {
+		//the game is over: checkmate or stalemate
+		result.score = position.getCheckers() ? -MATE : 0;
+	} else {
+		//until an iteration is completed, fall back on the first legal move
+		result.bestMove = moves[0];
+		result.pv[0] = moves[0];
+		result.pvLength = 1;
+	}
+
+	//every thread keeps to the depth limit, and helpers otherwise search until the main
+	//thread stops them. Odd helpers skip the first iteration, so they start an iteration
+	//ahead of the main thread and fill the table with different subtrees
+	int maxDepth = (limits.depth > 0) ? min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+	for (int depth = 1 + (threadId & 1); depth <= maxDepth && moves.size() > 0; depth++) {
+		int score = negamax(depth, 0, -INFINITE, INFINITE);
+		//an unfinished iteration has not looked at every move, so its result is dropped
+		if (stopped) {
+			break;
+		}
+		result.bestMove = pv[0][0];
+		result.score = score;
+		result.depth = depth;
+		result.pvLength = pvLength[0];
+		copy(pv[0], pv[0] + pvLength[0], result.pv);
+		copy(pv[0], pv[0] + pvLength[0], previousPv);
+		if (threadId != 0) {
+			continue;
+		}
+
+		uint64_t milliseconds = chrono::duration_cast<chrono::milliseconds>(
+			chrono::steady_clock::now() - start).count();
+		if (info) {
+			uint64_t searched = totalNodes->load(memory_order_relaxed) + (nodes & 1023);
+			*info << "depth " << depth << " score ";
+			if (abs(score) >= MATE - MAX_PLY) {
+				//moves to mate, negative when being mated
+				*info << "mate " << ((score > 0) ? (MATE - score + 1) / 2 : -(MATE + score) / 2);
+			} else {
+				*info << "cp " << score;
+			}
+			*info << " nodes " << searched << " time " << milliseconds << " nps "
+				  << searched * 1000 / max<uint64_t>(milliseconds, 1) << " hashfull "
+				  << table.hashfull() << " pv";
+			for (int index = 0; index < pvLength[0]; index++) {
+				*info << ' ' << pv[0][index];
+			}
+			*info << endl;
+		}
+		//a mate within the depth searched cannot be bettered by searching deeper
+		if (abs(score) >= MATE - depth) {
+			break;
+		}
+		//the next iteration takes longer than all before it, so do not start one that
+		//would only be cut off
+		if (limits.milliseconds && milliseconds * 2 >= limits.milliseconds) {
+			break;
+		}
+	}
+	//add the nodes not yet added in a batch
+	totalNodes->fetch_add(nodes & 1023, memory_order_relaxed);
+	return result;
+}
+
+int Search::negamax(int depth, int ply, int alpha, int beta) {
+	if (depth <= 0) {
+		return quiescence(ply, alpha, beta);
+	}
+	pvLength[ply] = 0;
+	if (countNode()) {
+		return 0;
+	}
+	keys[ply] = position.getKey();
+	//a repeated position or fifty moves with no capture or pawn move is a draw
+	if (ply > 0 && (position.getHalfmoveClock() >= 100 || isRepetition(ply))) {
+		return 0;
+	}
+	//a search of the position stored at this depth or deeper gives its score, if it is
+	//exact or a bound outside alpha and beta (except at the root, which needs a move)
+	TranspositionTable::Data stored;
+	Move tableMove;
+	if (table.probe(keys[ply], stored)) {
+		tableMove = stored.move;
+		int score = scoreFromTable(stored.score, ply);
+		if (ply > 0 && stored.depth >= depth
+				&& (stored.bound == TranspositionTable::EXACT
+					|| (stored.bound == TranspositionTable::LOWER && score >= beta)
+					|| (stored.bound == TranspositionTable::UPPER && score <= alpha))) {
+			return score;
+		}
+	}
+
+	MoveList moves;
+	position.generateLegalMoves(moves);
+	bool inCheck = position.getCheckers() != 0;
+	if (moves.size() == 0) {
+		//checkmate, scored so that a quicker mate is better, or stalemate
+		return inCheck ? -(MATE - ply) : 0;
+	}
+	if (ply >= MAX_PLY - 1) {
+		return evaluate(position);
+	}
+	//search a ply deeper out of check, so a check cannot push a threat out of sight
+	if (inCheck) {
+		depth++;
+	}
+
+	int scores[MoveList::CAPACITY];
+	scoreMoves(moves, scores, ply, tableMove);
+	int bestScore = -INFINITE;
+	Move bestMove;
+	int alphaBefore = alpha;
+	StateInfo state;
+	for (int index; (index = pickMove(moves, scores)) != -1; ) {
+		Move move = moves[index];
+		bool capture = isCapture(position, move);
+		//load the table entry of the position after the move while the move is made
+		table.prefetch(position.keyAfter(move));
+		position.doMove(move, state);
+		int score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+		position.undoMove(state);
+		if (stopped) {
+			return 0;
+		}
+		if (score > bestScore) {
+			bestScore = score;
+			bestMove = move;
+		}
+		if (score > alpha) {
+			alpha = score;
+			//the principal variation is this move then the one from the position after it
+			pv[ply][0] = move;
+			copy(pv[ply + 1], pv[ply + 1] + pvLength[ply + 1], pv[ply] + 1);
+			pvLength[ply] = pvLength[ply + 1] + 1;
+		}
+		if (alpha >= beta) {
+			//the opponent will not allow this position, so remember the quiet move that
+			//refuted it to try early in the other positions at this ply
+			if (!capture && move.type() != Move::PROMOTION && !(killers[ply][0] == move)) {
+				killers[ply][1] = killers[ply][0];
+				killers[ply][0] = move;
+			}
+			break;
+		}
+	}
+	TranspositionTable::BOUND bound = (bestScore >= beta) ? TranspositionTable::LOWER
+		: (bestScore > alphaBefore) ? TranspositionTable::EXACT : TranspositionTable::UPPER;
+	//a move that failed low is no better than the others, so it is not stored
+	table.store(keys[ply], (bound == TranspositionTable::UPPER) ? Move() : bestMove,
+				scoreToTable(bestScore, ply), depth, bound);
+	return bestScore;
+}
+
+int Search::quiescence(int ply, int alpha, int beta) {
+	pvLength[ply] = 0;
+	if (countNode()) {
+		return 0;
+	}
+	if (ply >= MAX_PLY - 1) {
+		return evaluate(position);
+	}
+	bool inCheck = position.getCheckers() != 0;
+	int bestScore = -INFINITE;
+	if (!inCheck) {
+		//the player who has the move can stand on the score of the position rather
+		//than capture
+		bestScore = evaluate(position);
+		if (bestScore >= beta) {
+			return bestScore;
+		}
+		alpha = max(alpha, bestScore);
+	}
+
+	MoveList moves;
+	position.generateLegalMoves(moves);
+	if (inCheck && moves.size() == 0) {
+		return -(MATE - ply);
+	}
+	int scores[MoveList::CAPACITY];
+	scoreMoves(moves, scores, ply, Move());
+	StateInfo state;
+	for (int index; (index = pickMove(moves, scores)) != -1; ) {
+		Move move = moves[index];
+		//out of check only captures and queen promotions are searched
+		if (!inCheck && !isCapture(position, move)
+			&& !(move.type() == Move::PROMOTION && move.promotion() == Position::QUEEN)) {
+			continue;
+		}
+		position.doMove(move, state);
+		int score = -quiescence(ply + 1, -beta, -alpha);
+		position.undoMove(state);
+		if (stopped) {
+			return 0;
+		}
+		if (score > bestScore) {
+			bestScore = score;
+			alpha = max(alpha, score);
+			if (alpha >= beta) {
+				break;
+			}
+		}
+	}
+	return bestScore;
+}
+
+void Search::scoreMoves(const MoveList& moves, int scores[], int ply, Move tableMove) const {
+	for (int index = 0; index < moves.size(); index++) {
+		Move move = moves[index];
+		if (move == tableMove) {
+			scores[index] = TABLE_SCORE;
+		} else if (move == previousPv[ply]) {
+			scores[index] = PV_SCORE;
+		} else if (isCapture(position, move) || move.type() == Move::PROMOTION) {
+			//most valuable victim first, then least valuable attacker
+			int victim = (move.type() == Move::EN_PASSANT || !(position.occupied() & squareBB(move.to())))
+						 ? Position::PAWN : position.typeOn(move.to());
+			if (move.type() == Move::PROMOTION) {
+				victim += move.promotion();
+			}
+			scores[index] = CAPTURE_SCORE + victim * 8 + Position::KING - position.typeOn(move.from());
+		} else if (move == killers[ply][0]) {
+			scores[index] = KILLER_SCORE;
+		} else if (move == killers[ply][1]) {
+			scores[index] = KILLER_SCORE - 1;
+		} else {
+			scores[index] = 0;
+		}
+	}
+}
+
+bool Search::countNode() {
+	//add to the count shared by the threads in batches, so they do not all write to one
+	//cache line at every node
+	if ((++nodes & 1023) == 0) {
+		totalNodes->fetch_add(1024, memory_order_relaxed);
+		//the main thread reads the clock only with each batch, as it is slow next to
+		//visiting a node
+		if (threadId == 0 && limits.milliseconds
+				&& uint64_t(chrono::duration_cast<chrono::milliseconds>(
+					chrono::steady_clock::now() - start).count()) >= limits.milliseconds) {
+			stop->store(true, memory_order_relaxed);
+		}
+	}
+	if (threadId == 0 && limits.nodes
+			&& totalNodes->load(memory_order_relaxed) + (nodes & 1023) >= limits.nodes) {
+		stop->store(true, memory_order_relaxed);
+	}
+	stopped = stop->load(memory_order_relaxed);
+	return stopped;
+}
+
+bool Search::isRepetition(int ply) const {
+	//a position can only repeat one with the same player to move, at least four plies back
+	int earliest = max(0, ply - position.getHalfmoveClock());
+	for (int previous = ply - 4; previous >= earliest; previous -= 2) {
+		if (keys[previous] == keys[ply]) {
+			return true;
+		}
+	}
+	return false;
+}
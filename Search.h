@@ -0,0 +1,171 @@
+/* Search.h - header file for the class Search and the structs SearchLimits and
+ * SearchResult */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include "MoveList.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+
+/******************* Struct SearchLimits *******************/
+
+/* When a search stops, at whichever limit is reached first (a limit of 0 is no limit)
+ */
+struct SearchLimits {
+	int depth; //deepest iteration to search, in plies
+	uint64_t nodes; //most nodes to visit
+	uint64_t milliseconds; //most time to take
+};
+
+/******************* Struct SearchResult *******************/
+
+/* The best move found by a search, from its deepest completed iteration
+ */
+struct SearchResult {
+	static const int MAX_PV = 64; //longest principal variation kept
+
+	Move bestMove; //best move found, or an empty Move if there is no legal move
+	int score; //score of the best move for the player who has the move, in centipawns,
+			   //or Search::MATE less the plies to mate (negative when being mated)
+	int depth; //depth of the deepest completed iteration
+	uint64_t nodes; //positions visited by every thread, including those of an unfinished
+					//iteration
+	uint64_t milliseconds; //time taken
+	uint64_t nodesPerSecond; //nodes visited per second
+	Move pv[MAX_PV]; //principal variation, starting with bestMove
+	int pvLength; //number of moves in pv
+};
+
+/******************* Class Search *******************/
+
+/* A negamax alpha-beta search with iterative deepening and a quiescence search of
+ * captures, on its own copy of a position that it makes and undoes moves on, so no
+ * heap memory is used once it is created
+ *
+ * Searched positions are stored in a TranspositionTable, whose best move is tried first
+ * and whose score cuts the search short where it is deep enough. Then moves are tried in
+ * the order of the last iteration's principal variation, captures by most valuable
+ * victim and least valuable attacker, then two killer moves a ply. Positions are scored
+ * by material and piece-square tables
+ *
+ * A search can use several threads (Lazy SMP): helper threads search copies of the
+ * position with their own move ordering, sharing only the table, so each thread finds
+ * the positions the others have searched. Every thread keeps to the depth limit, and the
+ * main thread keeps to the node and time limits and stops the helpers when it finishes
+ */
+class Search {
+	public:
+		static const int MAX_PLY = SearchResult::MAX_PV; //deepest ply searched
+		static const int MATE = 32000; //score of checkmating now
+		static const int INFINITE = 32001; //larger than any score
+
+		/* Creates an instance of Search
+		 *
+		 * @param position: the position to search, which is copied
+		 * @param table: table to store searched positions in, kept between searches
+		 */
+		Search(const Position& position, TranspositionTable& table);
+
+		/* Searches one ply deeper each iteration until a limit is reached, the deepest
+		 * iteration is done or a forced mate is found
+		 *
+		 * @param limits: when to stop
+		 * @param info: output stream to print a line to after each iteration of the main
+		 *				thread (depth, score, nodes, time, nodes per second, share of the
+		 *				table used and principal variation), or NULL to print nothing
+		 * @param threads: number of threads to search with, the calling thread being the
+		 *				   main thread
+		 * @returns: the best move, score and principal variation of the deepest
+		 *			 iteration completed by any thread, with the nodes of every thread
+		 */
+		SearchResult run(const SearchLimits& limits, std::ostream* info = NULL,
+						 int threads = 1);
+
+		/* Scores a position by material and piece-square tables
+		 *
+		 * @param position: the position to score
+		 * @returns: score for the player who has the move, in centipawns
+		 */
+		static int evaluate(const Position& position);
+
+	private:
+		Position position; //the position searched, returned to the root after each move
+		TranspositionTable& table; //table of searched positions
+		SearchLimits limits; //when to stop the current search
+		std::chrono::steady_clock::time_point start; //when the current search started
+		uint64_t nodes; //positions visited by this thread in the current search
+		bool stopped; //whether the search was stopped during the current iteration
+		int threadId; //number of the thread searching, 0 for the main thread
+		std::atomic<bool>* stop; //set to stop every thread of the current search
+		std::atomic<uint64_t>* totalNodes; //positions visited by every thread, added
+										   //1024 at a time
+		uint64_t keys[MAX_PLY + 1]; //hash of the position at each ply, for repetitions
+		Move killers[MAX_PLY][2]; //quiet moves that caused a cut-off at each ply
+		Move previousPv[MAX_PLY]; //principal variation of the last completed iteration
+		Move pv[MAX_PLY][MAX_PLY]; //principal variation from each ply of the current line
+		int pvLength[MAX_PLY]; //number of moves in each principal variation
+
+		/* Searches one ply deeper each iteration on one thread (see run)
+		 *
+		 * @param limits: when to stop, the node and time limits only kept to by the main thread
+		 * @param info: output stream to print each iteration to, or NULL
+		 * @param threadId: number of the thread, 0 for the main thread
+		 * @param stop: flag that stops every thread, set by the main thread
+		 * @param totalNodes: count of the nodes of every thread
+		 * @returns: the best move, score and principal variation of the deepest
+		 *			 iteration completed by this thread
+		 */
+		SearchResult iterate(const SearchLimits& limits, std::ostream* info, int threadId,
+							 std::atomic<bool>& stop, std::atomic<uint64_t>& totalNodes);
+
+		/* Searches the position to a depth with negamax alpha-beta
+		 *
+		 * @param depth: plies left to search before the quiescence search
+		 * @param ply: plies from the root
+		 * @param alpha: score the player who has the move is already sure of
+		 * @param beta: score the opponent is already sure of
+		 * @returns: the score of the position, or a bound on it outside alpha and beta
+		 */
+		int negamax(int depth, int ply, int alpha, int beta);
+
+		/* Searches only captures and promotions (or every move when in check) until the
+		 * position is quiet, so a position is not scored in the middle of an exchange
+		 *
+		 * @param ply: plies from the root
+		 * @param alpha: score the player who has the move is already sure of
+		 * @param beta: score the opponent is already sure of
+		 * @returns: the score of the position, or a bound on it outside alpha and beta
+		 */
+		int quiescence(int ply, int alpha, int beta);
+
+		/* Scores each move for the order they are tried in
+		 *
+		 * @param moves: the moves
+		 * @param scores: set to the score of each move, highest first to try
+		 * @param ply: plies from the root
+		 * @param tableMove: best move stored for the position, or an empty Move
+		 */
+		void scoreMoves(const MoveList& moves, int scores[], int ply, Move tableMove) const;
+
+		/* Counts a node, checks the node and time limits on the main thread, and checks
+		 * whether the main thread has stopped the search
+		 *
+		 * @returns: whether the search must stop
+		 */
+		bool countNode();
+
+		/* Checks whether the position at a ply repeats one earlier in the line searched
+		 * since the last capture or pawn move
+		 *
+		 * @param ply: plies from the root
+		 * @returns: whether the position is a repetition
+		 */
+		bool isRepetition(int ply) const;
+};
+
+#endif
@@ -0,0 +1,26 @@
+/* StateInfo.h - header file for the struct StateInfo */
+
+#ifndef STATEINFO_H
+#define STATEINFO_H
+
+#include <cstdint>
+#include "Bitboard.h"
+#include "MoveList.h"
+
+/******************* Struct StateInfo *******************/
+
+/* The state of a Position before a move that cannot be worked out from the position
+ * after it, filled by Position::doMove and used by Position::undoMove
+ */
+struct StateInfo {
+	Move move; //the move that was made
+	int8_t captured; //type of the piece taken by the move (a Position::PIECE), or -1
+	Bitboard checkers; //checking pieces before the move
+	Bitboard pinned; //pinned pieces before the move
+	uint64_t key; //hash of the position before the move
+	int8_t epSquare; //en passant square before the move, or -1
+	uint8_t castlingRights; //castling availability before the move
+	uint16_t halfmoveClock; //moves since the last capture or pawn move, before the move
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "Stats.h"
+
+using namespace std;
+
+//names of the counters, indexed by COUNTER
+static const char* const counterNames[Stats::COUNTER_NB] = {
+	"loadState", "submitMove", "tryValidMove", "makeMove", "unmakeMove",
+	"generateLegalMoves", "doMove", "undoMove", "isLegal", "attackersBy", "pieceMoves"
+};
+
+/* The counters of one thread, which only that thread writes, so they are updated with
+ * plain loads and stores that other threads can still read safely
+ */
+struct ThreadStats {
+	atomic<uint64_t> counts[Stats::COUNTER_NB];
+	atomic<uint64_t> nanoseconds[Stats::COUNTER_NB];
+
+	/* Creates an instance of ThreadStats with every counter at zero, and registers it
+	 */
+	ThreadStats();
+
+	/* Destructor for ThreadStats keeps the counters of the exiting thread in the totals
+	 */
+	~ThreadStats();
+};
+
+static mutex registryMutex; //guards registry and retired
+static vector<ThreadStats*> registry; //the counters of each running thread
+static Stats::Snapshot retired = {}; //the counters of threads that have exited
+static thread_local ThreadStats threadStats; //the counters of the calling thread
+
+ThreadStats::ThreadStats() {
+	for (int counter = 0; counter < Stats::COUNTER_NB; counter++) {
+		counts[counter] = 0;
+		nanoseconds[counter] = 0;
+	}
+	lock_guard<mutex> lock(registryMutex);
+	registry.push_back(this);
+}
+
+ThreadStats::~ThreadStats() {
+	lock_guard<mutex> lock(registryMutex);
+	for (int counter = 0; counter < Stats::COUNTER_NB; counter++) {
+		retired.counts[counter] += counts[counter];
+		retired.nanoseconds[counter] += nanoseconds[counter];
+	}
+	for (size_t index = 0; index < registry.size(); index++) {
+		if (registry[index] == this) {
+			registry.erase(registry.begin() + index);
+			break;
+		}
+	}
+}
+
+/* Adds to a counter only the calling thread writes
+ *
+ * @param value: the counter
+ * @param amount: the amount to add
+ */
+static void addTo(atomic<uint64_t>& value, uint64_t amount) {
+	//a load and store, rather than a locked add, since no other thread writes the value
+	value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+void Stats::count(COUNTER counter) {
+	addTo(threadStats.counts[counter], 1);
+}
+
+void Stats::time(COUNTER counter, uint64_t nanoseconds) {
+	addTo(threadStats.counts[counter], 1);
+	addTo(threadStats.nanoseconds[counter], nanoseconds);
+}
+
+Stats::Snapshot Stats::snapshot() {
+	lock_guard<mutex> lock(registryMutex);
+	Snapshot totals = retired;
+	for (const ThreadStats* stats : registry) {
+		for (int counter = 0; counter < COUNTER_NB; counter++) {
+			totals.counts[counter] += stats->counts[counter].load(memory_order_relaxed);
+			totals.nanoseconds[counter] += stats->nanoseconds[counter].load(memory_order_relaxed);
+		}
+	}
+	return totals;
+}
+
+void Stats::reset() {
+	lock_guard<mutex> lock(registryMutex);
+	retired = Snapshot();
+	for (ThreadStats* stats : registry) {
+		for (int counter = 0; counter < COUNTER_NB; counter++) {
+			stats->counts[counter].store(0, memory_order_relaxed);
+			stats->nanoseconds[counter].store(0, memory_order_relaxed);
+		}
+	}
+}
+
+void Stats::dump(ostream& output, bool json) {
+	Snapshot totals = snapshot();
+	bool first = true;
+	output << (json ? "{" : "Counter               Calls        Total ms   ns/call\n");
+	for (int counter = 0; counter < COUNTER_NB; counter++) {
+		//only print the hot paths that were called
+		if (totals.counts[counter] == 0) {
+			continue;
+		}
+		double milliseconds = totals.nanoseconds[counter] / 1e6;
+		double nsPerCall = double(totals.nanoseconds[counter]) / totals.counts[counter];
+		if (json) {
+			output << (first ? "\n" : ",\n") << "  \"" << counterNames[counter]
+				   << "\": {\"calls\": " << totals.counts[counter];
+			//only the timed hot paths have a time
+			if (totals.nanoseconds[counter]) {
+				output << ", \"ms\": " << milliseconds << ", \"ns_per_call\": " << nsPerCall;
+			}
+			output << '}';
+		} else {
+			output.width(22);
+			output << std::left << counterNames[counter];
+			output.width(13);
+			output << totals.counts[counter];
+			if (totals.nanoseconds[counter]) {
+				output.width(11);
+				output << milliseconds << nsPerCall;
+			}
+			output << std::right << '\n';
+		}
+		first = false;
+	}
+	output << (json ? "\n}\n" : "");
+	output.flush();
+}
@@ -0,0 +1,109 @@
+/* Stats.h - header file for the class Stats */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+/******************* Class Stats *******************/
+
+/* Counts of calls to the hot paths, and the time spent in the ones that are timed, kept
+ * per thread and added together when read
+ *
+ * The STATS_COUNT and STATS_TIME macros only count when built with USE_STATS defined
+ * (make STATS=1), so the hot paths cost nothing extra otherwise
+ */
+class Stats {
+	public:
+		/* Represents a hot path that is counted
+		 *
+		 * @value LOAD_STATE: ChessBoard::loadState (timed)
+		 * @value SUBMIT_MOVE: ChessBoard::submitMove (timed)
+		 * @value TRY_VALID_MOVE: ChessBoard::tryValidMove
+		 * @value MAKE_MOVE: ChessBoard::makeMove
+		 * @value UNMAKE_MOVE: ChessBoard::unmakeMove
+		 * @value GENERATE_LEGAL_MOVES: Position::generateLegalMoves (timed)
+		 * @value DO_MOVE: Position::doMove
+		 * @value UNDO_MOVE: Position::undoMove
+		 * @value IS_LEGAL: Position::isLegal
+		 * @value ATTACKERS_BY: Position::attackersBy, the attack probe from a square
+		 * @value PIECE_MOVES: Position::pieceMoves, the movement rules tryValidMove checks a
+		 *		  move against when the cached legal moves are stale
+		 * @value COUNTER_NB: number of counters
+		 */
+		enum COUNTER {LOAD_STATE, SUBMIT_MOVE, TRY_VALID_MOVE, MAKE_MOVE, UNMAKE_MOVE,
+					  GENERATE_LEGAL_MOVES, DO_MOVE, UNDO_MOVE, IS_LEGAL, ATTACKERS_BY,
+					  PIECE_MOVES, COUNTER_NB};
+
+		/* The totals of every counter over all threads at one time
+		 */
+		struct Snapshot {
+			uint64_t counts[COUNTER_NB]; //calls to each hot path
+			uint64_t nanoseconds[COUNTER_NB]; //time spent in each timed hot path
+		};
+
+		/* Adds a call to a counter of the calling thread
+		 *
+		 * @param counter: the hot path called
+		 */
+		static void count(COUNTER counter);
+
+		/* Adds a call and the time it took to a counter of the calling thread
+		 *
+		 * @param counter: the hot path called
+		 * @param nanoseconds: time spent in the call
+		 */
+		static void time(COUNTER counter, uint64_t nanoseconds);
+
+		/* Adds up the counters of every thread, including threads that have exited
+		 *
+		 * @returns: the totals
+		 */
+		static Snapshot snapshot();
+
+		/* Sets the counters of every thread to zero
+		 */
+		static void reset();
+
+		/* Prints the totals of every counter that has been called
+		 *
+		 * @param output: the output stream to write to
+		 * @param json: whether to print JSON instead of text
+		 */
+		static void dump(std::ostream& output, bool json);
+
+		/* Times the scope it is declared in, adding it to a counter when the scope ends
+		 */
+		class ScopedTimer {
+			public:
+				/* Creates an instance of ScopedTimer, starting the timer
+				 *
+				 * @param _counter: the hot path being timed
+				 */
+				ScopedTimer(COUNTER _counter)
+					: counter(_counter), start(std::chrono::steady_clock::now()) {}
+
+				/* Destructor for ScopedTimer adds the time since it was created
+				 */
+				~ScopedTimer() {
+					time(counter, std::chrono::duration_cast<std::chrono::nanoseconds>(
+						std::chrono::steady_clock::now() - start).count());
+				}
+
+			private:
+				COUNTER counter; //the hot path being timed
+				std::chrono::steady_clock::time_point start; //when the timer was created
+		};
+};
+
+#ifdef USE_STATS
+#define STATS_COUNT(counter) Stats::count(Stats::counter)
+#define STATS_TIME(counter) Stats::ScopedTimer statsTimer(Stats::counter)
+#else
+#define STATS_COUNT(counter)
+#define STATS_TIME(counter)
+#endif
+
+#endif
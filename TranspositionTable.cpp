@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "TranspositionTable.h"
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+//the generation and bound of an entry are 8 bits of its data, with the bound in the low
+//2 bits and the generation in the top 6
+static const int GENERATION_BOUND_SHIFT = 40;
+static const uint8_t BOUND_MASK = 3;
+static const uint8_t GENERATION_STEP = 4;
+
+/* Gets the generation and bound from the data of an entry
+ *
+ * @param data: data of the entry
+ * @returns: the generation in the top 6 bits and the BOUND in the low 2
+ */
+static uint8_t generationBoundOf(uint64_t data) {
+	return uint8_t(data >> GENERATION_BOUND_SHIFT);
+}
+
+//size and alignment of a huge page, which the table is allocated on where it is big enough
+static const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+TranspositionTable::TranspositionTable(size_t megabytes) : buckets(NULL), mask(0), generation(0) {
+	resize(megabytes);
+}
+
+TranspositionTable::~TranspositionTable() {
+	free(buckets);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+	size_t count = 1;
+	while (count * 2 * sizeof(Bucket) <= megabytes << 20) {
+		count *= 2;
+	}
+	size_t bytes = count * sizeof(Bucket);
+	//align a table of whole huge pages to them, so the system can back it with huge pages
+	//and a probe's page lookup is almost always in the TLB
+	size_t alignment = (bytes % HUGE_PAGE_SIZE == 0) ? HUGE_PAGE_SIZE : sizeof(Bucket);
+	//allocate the new table before freeing the old one, so a failure leaves the old one
+	void* memory = NULL;
+	if (posix_memalign(&memory, alignment, bytes) != 0) {
+		throw bad_alloc();
+	}
+	free(buckets);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	if (alignment == HUGE_PAGE_SIZE) {
+		madvise(memory, bytes, MADV_HUGEPAGE);
+	}
+#endif
+	buckets = static_cast<Bucket*>(memory);
+	mask = count - 1;
+	clear();
+}
+
+void TranspositionTable::clear() {
+	//touching every page also makes the system give the table its memory now, rather than
+	//during the first search
+	memset(static_cast<void*>(buckets), 0, (mask + 1) * sizeof(Bucket));
+	generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+	generation += GENERATION_STEP;
+}
+
+bool TranspositionTable::probe(uint64_t key, Data& data) const {
+	for (const Entry& entry : buckets[key & mask].entries) {
+		uint64_t bits = entry.data.load(memory_order_relaxed);
+		//an entry of another position, or one torn by two threads, fails the check
+		if ((entry.check.load(memory_order_relaxed) ^ bits) == key
+				&& (generationBoundOf(bits) & BOUND_MASK) != NONE) {
+			data.move = Move::fromRaw(uint16_t(bits));
+			data.score = int16_t(bits >> 16);
+			data.depth = uint8_t(bits >> 32);
+			data.bound = static_cast<BOUND>(generationBoundOf(bits) & BOUND_MASK);
+			return true;
+		}
+	}
+	return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, BOUND bound) {
+	Bucket& bucket = buckets[key & mask];
+	//use the position's own entry if it has one, or else the entry that is worth the
+	//least: an empty one, or the shallowest search, counting each search since it was
+	//stored as 8 plies shallower so that old entries make way
+	Entry* replace = NULL;
+	uint64_t replaceBits = 0;
+	int replaceWorth = 0;
+	for (Entry& entry : bucket.entries) {
+		uint64_t bits = entry.data.load(memory_order_relaxed);
+		uint8_t generationBound = generationBoundOf(bits);
+		if ((entry.check.load(memory_order_relaxed) ^ bits) == key
+				&& (generationBound & BOUND_MASK) != NONE) {
+			//a deeper search of the position by this search is worth more than a
+			//shallower bound, which only replaces it if it is exact
+			if ((generationBound & ~BOUND_MASK) == generation && int(uint8_t(bits >> 32)) > depth
+					&& bound != EXACT) {
+				return;
+			}
+			replace = &entry;
+			replaceBits = bits;
+			break;
+		}
+		int age = uint8_t(generation - (generationBound & ~BOUND_MASK)) / GENERATION_STEP;
+		int worth = ((generationBound & BOUND_MASK) == NONE) ? -256
+					: int(uint8_t(bits >> 32)) - 8 * age;
+		if (!replace || worth < replaceWorth) {
+			replace = &entry;
+			replaceBits = 0;
+			replaceWorth = worth;
+		}
+	}
+	//keep the stored best move if the new search did not find one
+	uint16_t moveBits = (move == Move()) ? uint16_t(replaceBits) : move.raw();
+	uint64_t bits = uint64_t(moveBits) | uint64_t(uint16_t(score)) << 16
+		| uint64_t(uint8_t(depth)) << 32 | uint64_t(generation | bound) << GENERATION_BOUND_SHIFT;
+	replace->data.store(bits, memory_order_relaxed);
+	replace->check.store(key ^ bits, memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+	//count the entries of the current search among the first thousand
+	size_t sampled = min<size_t>(1000 / BUCKET_SIZE, mask + 1);
+	int used = 0;
+	for (size_t index = 0; index < sampled; index++) {
+		for (const Entry& entry : buckets[index].entries) {
+			uint8_t generationBound = generationBoundOf(entry.data.load(memory_order_relaxed));
+			if ((generationBound & BOUND_MASK) != NONE
+					&& (generationBound & ~BOUND_MASK) == generation) {
+				used++;
+			}
+		}
+	}
+	return used * 1000 / int(sampled * BUCKET_SIZE);
+}
+
+size_t TranspositionTable::size() const {
+	return (mask + 1) * sizeof(Bucket);
+}
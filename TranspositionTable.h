@@ -0,0 +1,142 @@
+/* TranspositionTable.h - header file for the class TranspositionTable */
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include "MoveList.h"
+
+/******************* Class TranspositionTable *******************/
+
+/* Table of the results of searched positions, keyed by position hash, so a position
+ * reached again by another move order is not searched again
+ *
+ * Entries are 16 bytes, grouped four to a 64 byte bucket that fills one cache line, and
+ * a position can be stored in any entry of its bucket. The table is allocated once, on
+ * huge pages where the system has them, and the search prefetches a bucket while it
+ * makes the move that leads to it
+ *
+ * Search threads share the table without locks: each entry stores its key XORed with
+ * its data, so an entry torn by two threads writing at once fails the check and is
+ * ignored
+ */
+class TranspositionTable {
+	public:
+		/* Represents what a stored score says about the real score of a position
+		 *
+		 * @value NONE: the entry is empty
+		 * @value UPPER: the real score is at most the stored score (no move beat alpha)
+		 * @value LOWER: the real score is at least the stored score (a move beat beta)
+		 * @value EXACT: the stored score is the real score
+		 */
+		enum BOUND {NONE, UPPER, LOWER, EXACT};
+
+		/* A stored search result, as read back from the table
+		 */
+		struct Data {
+			Move move; //best move found, or an empty Move
+			int score; //score for the player who has the move
+			int depth; //depth the position was searched to
+			BOUND bound; //what the score says about the real score
+		};
+
+		/* Creates an instance of an empty TranspositionTable
+		 *
+		 * @param megabytes: size of the table, rounded down to a power of two buckets
+		 */
+		TranspositionTable(size_t megabytes);
+
+		/* Destructor for TranspositionTable frees the table
+		 */
+		~TranspositionTable();
+
+		TranspositionTable(const TranspositionTable&) = delete;
+		TranspositionTable& operator = (const TranspositionTable&) = delete;
+
+		/* Replaces the table with an empty one of another size, keeping the old table if
+		 * the new one cannot be allocated (throwing std::bad_alloc)
+		 *
+		 * @param megabytes: size of the table, rounded down to a power of two buckets
+		 */
+		void resize(size_t megabytes);
+
+		/* Empties every entry
+		 */
+		void clear();
+
+		/* Starts a new search, so the entries of earlier searches are replaced first
+		 */
+		void newSearch();
+
+		/* Looks up a position
+		 *
+		 * @param key: hash of the position
+		 * @param data: set to the stored result if it is found
+		 * @returns: whether the position was found
+		 */
+		bool probe(uint64_t key, Data& data) const;
+
+		/* Stores the result of a search of a position, in its entry if it has one, or
+		 * else in place of the entry of its bucket with the shallowest and oldest search.
+		 * An entry of the position from a deeper search by the current search is kept,
+		 * unless the new score is exact
+		 *
+		 * @param key: hash of the position
+		 * @param move: best move found, or an empty Move to keep any stored move
+		 * @param score: score for the player who has the move
+		 * @param depth: depth the position was searched to
+		 * @param bound: what the score says about the real score
+		 */
+		void store(uint64_t key, Move move, int score, int depth, BOUND bound);
+
+		/* Starts loading the bucket of a position into the cache, so a probe of it
+		 * shortly after does not wait for memory
+		 *
+		 * @param key: hash of the position
+		 */
+		void prefetch(uint64_t key) const {
+			__builtin_prefetch(&buckets[key & mask]);
+		}
+
+		/* Gets the share of entries used by the current search, from a sample of them
+		 *
+		 * @returns: entries used per thousand
+		 */
+		int hashfull() const;
+
+		/* Getter for the size of the table
+		 *
+		 * @returns: size of the table in bytes
+		 */
+		size_t size() const;
+
+	private:
+		static const int BUCKET_SIZE = 4; //entries in a bucket
+
+		/* A stored search result
+		 */
+		struct Entry {
+			std::atomic<uint64_t> check; //key XORed with data
+			std::atomic<uint64_t> data; //best move in bits 0-15, score in 16-31, depth in
+										//32-39, search the entry was stored by in 42-47
+										//and BOUND in 40-41
+		};
+
+		/* The entries a position can be stored in, filling a cache line
+		 */
+		struct alignas(64) Bucket {
+			Entry entries[BUCKET_SIZE];
+		};
+
+		static_assert(sizeof(Entry) == 16 && sizeof(Bucket) == 64,
+					  "a Bucket must be four 16 byte Entries filling a cache line");
+
+		Bucket* buckets; //the table, a power of two buckets long
+		size_t mask; //number of buckets minus one, to index with the low bits of a key
+		uint8_t generation; //number of the current search in the top 6 bits, changed
+							//only between searches
+};
+
+#endif
@@ -38,9 +38,9 @@ int main () {
 	cb.submitMove("A1", "C1");
 	cb.submitMove("H8", "G8");
 	cb.submitMove("C1", "A1");
-	cb.submitMove("E8", "B8");
+	cb.submitMove("E8", "C8");
 	cb.submitMove("A1", "C1");
-	cb.submitMove("G8", "D8");
+	cb.submitMove("G8", "E8");
 	cb.submitMove("E1", "G1");
 	*/
 	/*cb.loadState("r3k2r/8/8/8/8/8/8/R3K2R w KQkq"); //check castling
@@ -48,11 +48,18 @@ int main () {
 	cb.submitMove("E8", "G8");
 	cb.submitMove("C1", "A1");
 	cb.submitMove("F8", "C8");
-	cb.submitMove("E1", "B1");
+	cb.submitMove("E1", "C1");
 	cb.submitMove("E1", "G1");
 	*/
 	/*cb.loadState("r3k2r/8/8/8/8/8/6q1/R3K2R w KQkq"); //check cannot castle (q)
-	cb.submitMove("E1", "B1");
+	cb.submitMove("E1", "C1");
+	*/
+	/*cb.loadState("4k3/3p4/8/4P3/8/8/8/4K3 b - "); //check en passant
+	cb.submitMove("D7", "D5");
+	cb.submitMove("E5", "D6");
+	*/
+	/*cb.loadState("1n2k3/P7/8/8/8/8/8/4K3 w - "); //check promotion
+	cb.submitMove("A7", "B8");
 	*/
 	cout << cb << endl;
 	char c[3];